@@ -68,6 +68,16 @@ public:
   // Solve for a particular right hand side, and return in an existing vector objects
   virtual void solve(Vector<T>& x, const Vector<T>& rhs) = 0;
 
+  // Solve for many right hand sides at once, given as the columns of B. The solutions are returned as the columns of
+  // X. Where the backend supports it, all columns are solved in one blocked pass over the factorization, which is much
+  // faster than solving for each column in turn.
+  virtual void solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) = 0;
+
+  // Factor a new matrix with the same size and sparsity pattern as the original one (only the values differ, as when
+  // a mesh deforms). Reuses the symbolic analysis and fill-reducing ordering from the original factorization, so this
+  // is cheaper than constructing a new solver. Throws if the sparsity pattern has changed.
+  virtual void refactor(const SparseMatrix<T>& mat) = 0;
+
 protected:
   size_t nRows, nCols;
 };
@@ -87,6 +97,10 @@ public:
   // Solve!
   void solve(Vector<T>& x, const Vector<T>& rhs) override;
   Vector<T> solve(const Vector<T>& rhs) override;
+  void solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) override;
+
+  // Factor a new matrix with the same sparsity pattern
+  void refactor(const SparseMatrix<T>& mat) override;
 
   // Gets the rank of the system
   size_t rank();
@@ -96,18 +110,46 @@ protected:
   std::unique_ptr<QRSolverInternals<T>> internals;
 };
 
+// How PositiveDefiniteSolver factors its matrix. These only take effect with Suitesparse; the Eigen fallback always
+// uses a simplicial LDLt.
+//   - Auto: simplicial LDLt for small systems, supernodal LLt for large ones (CHOLMOD chooses, based on the size and
+//     density of the factor). If the supernodal LLt fails because the matrix is only semi-definite, falls back to a
+//     simplicial LDLt. Worth asking for when the matrix is known to be definite, like M + tL.
+//   - SimplicialLDLT (default): always simplicial LDLt, which also handles semi-definite matrices
+//   - SupernodalLLT: always supernodal LLt, which is much faster for large systems but requires a definite matrix
+enum class CholeskyMode { Auto = 0, SimplicialLDLT, SupernodalLLT };
+
+// Fill-reducing ordering used by PositiveDefiniteSolver (Suitesparse only; the Eigen fallback always uses AMD).
+//   - Default: CHOLMOD's default strategy, which tries AMD, and METIS if the AMD ordering has much fill
+//   - AMD: approximate minimum degree
+//   - METIS: METIS nested dissection (requires CHOLMOD built with METIS)
+//   - NestedDissection: CHOLMOD's own nested dissection (also requires METIS), slower to compute but often better for
+//     very large meshes
+enum class CholeskyOrdering { Default = 0, AMD, METIS, NestedDissection };
+
 template <typename T>
 struct PSDSolverInternals; // hide implementation details
 template <typename T>
 class PositiveDefiniteSolver final : public LinearSolver<T> {
 
 public:
-  PositiveDefiniteSolver(SparseMatrix<T>& mat);
+  PositiveDefiniteSolver(SparseMatrix<T>& mat, CholeskyMode mode = CholeskyMode::SimplicialLDLT,
+                         CholeskyOrdering ordering = CholeskyOrdering::Default);
   ~PositiveDefiniteSolver();
 
   // Solve!
   void solve(Vector<T>& x, const Vector<T>& rhs) override;
   Vector<T> solve(const Vector<T>& rhs) override;
+  void solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) override;
+
+  // Factor a new matrix with the same sparsity pattern
+  void refactor(const SparseMatrix<T>& mat) override;
+
+  // Update the factorization to that of A + delta, where delta is a low-rank change (e.g. from changing the weights of
+  // a few edges, which may also add or remove entries). With Suitesparse and a real matrix, the factor is modified by
+  // rank-one updates/downdates, in time proportional to the affected columns of the factor rather than a full
+  // refactorization.
+  void update(const SparseMatrix<T>& delta);
 
 protected:
   std::unique_ptr<PSDSolverInternals<T>> internals;
@@ -125,6 +167,10 @@ public:
   // Solve!
   void solve(Vector<T>& x, const Vector<T>& rhs) override;
   Vector<T> solve(const Vector<T>& rhs) override;
+  void solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) override;
+
+  // Factor a new matrix with the same sparsity pattern
+  void refactor(const SparseMatrix<T>& mat) override;
 
 protected:
   // Implementation-specific quantities
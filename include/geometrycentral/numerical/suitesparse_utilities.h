@@ -31,6 +31,11 @@ public:
   // set mode for Cholesky factorization
   void setSimplicial();
   void setSupernodal();
+  void setAutoSupernodal(); // let cholmod choose between simplicial and supernodal
+
+  // set the fill-reducing ordering to a single method (like CHOLMOD_AMD), or back to cholmod's default strategy
+  void setOrdering(int method);
+  void setDefaultOrdering();
 
   // set LL vs LDL mode
   void setLL();
@@ -61,8 +66,28 @@ cholmod_sparse* toCholmod(Eigen::SparseMatrix<T, Eigen::ColMajor>& A, CholmodCon
 template <typename T>
 cholmod_dense* toCholmod(const Eigen::Matrix<T, Eigen::Dynamic, 1>& v, CholmodContext& context);
 
+// Overwrite the values of a previously converted sparse matrix with those of A, which must have the same sparsity
+// pattern. Returns false, leaving cMat unchanged, if the patterns differ.
+template <typename T>
+bool copyValuesToCholmod(const Eigen::SparseMatrix<T, Eigen::ColMajor>& A, cholmod_sparse* cMat);
+
 // Convert a vector
 template <typename T>
 void toEigen(cholmod_dense* cVec, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, 1>& xOut);
 
+// Convert a dense matrix (such as several vectors stored as columns)
+template <typename T>
+cholmod_dense* toCholmod(const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& M, CholmodContext& context);
+
+// Convert a dense matrix
+template <typename T>
+void toEigen(cholmod_dense* cMat, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+
+// === Views
+// Wrap an existing column-major buffer as a cholmod_dense, without copying. The result is only a header: it does not
+// own the data, and must never be passed to cholmod_l_free_dense(). (Only double precision buffers can be wrapped,
+// since cholmod always uses double precision.)
+cholmod_dense cholmodDenseView(double* data, size_t nRows, size_t nCols);
+cholmod_dense cholmodDenseView(std::complex<double>* data, size_t nRows, size_t nCols);
+
 } // namespace geometrycentral
@@ -5,6 +5,9 @@
 #include "geometrycentral/utilities/vector2.h"
 #include "geometrycentral/utilities/vector3.h"
 
+#include <functional>
+#include <vector>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -27,6 +30,21 @@ public:
   // Clear out any cached quantities which were previously computed but are not currently required.
   void purgeQuantities();
 
+  // Quantities computed while the mesh is frozen hold containers which are not registered with it, so the mesh cannot be
+  // unfrozen while they are cached (see HalfedgeMesh::freeze()). Either purge them (which only clears quantities that
+  // are not required), or call this first to register them with the mesh, keeping every cached quantity valid:
+  //   geometry.thawQuantities();
+  //   mesh.unfreeze();
+  // Call it while the mesh is still frozen, and not concurrently with any other use of this geometry.
+  void thawQuantities();
+
+  // Require several quantities at once, computing them concurrently on up to nThreads threads (by default, one per
+  // core). Each function should call one of the require methods, like
+  //   geometry.requireAll({[&]() { geometry.requireEdgeLengths(); }, [&]() { geometry.requireFaceNormals(); }});
+  // Quantities which the requested ones share as dependencies are still computed only once; a thread which needs one
+  // that another thread is computing waits for it.
+  void requireAll(const std::vector<std::function<void()>>& requireFuncs, size_t nThreads = 0);
+
   // Construct a geometry object on another mesh identical to this one
   // TODO move this to exist in realizations only
   std::unique_ptr<BaseGeometryInterface> reinterpretTo(HalfedgeMesh& targetMesh);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "geometrycentral/surface/halfedge_mesh.h"
+#include "geometrycentral/utilities/utilities.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+// NOTE: ipp includes at bottom of file
+
+namespace geometrycentral {
+namespace surface {
+
+// A compact connectivity structure for manifold triangle meshes (with or without boundary).
+//
+// Halfedges are stored three per face: halfedge 3*f+k is the k'th halfedge of face f, so he.next(), he.face() and
+// f.halfedge() are implicit index arithmetic rather than array lookups. The only per-halfedge storage is he.vertex()
+// and he.twin(), which uses about 40% less memory than HalfedgeMesh. The price is that there are no exterior
+// halfedges or boundary loops (he.twin() is INVALID_IND along the boundary), no edge indices, and no MeshData
+// containers; elements are referred to by plain indices. HalfedgeMesh's implicit twin/edge indexing cannot coexist
+// with implicit next(), which is why this is a separate class rather than a mode of HalfedgeMesh.
+//
+// Useful for navigation-heavy kernels and triangle remeshing loops, supporting flip(), splitEdge() and
+// insertVertex(). Use toHalfedgeMesh() to get a general mesh back.
+class CompactTriangleMesh {
+
+public:
+  // Build from a list of triangles, with 0-indexed vertices in CCW order. The same requirements as the HalfedgeMesh
+  // constructors apply (manifold, and the vertex indexing is dense).
+  CompactTriangleMesh(const std::vector<std::array<size_t, 3>>& triangles);
+
+  // Build from a triangular HalfedgeMesh. Vertex and face indices match mesh.getVertexIndices() and
+  // mesh.getFaceIndices(), and halfedge 3*f+k is the k'th halfedge of face f starting from f.halfedge().
+  CompactTriangleMesh(HalfedgeMesh& mesh);
+
+  // Number of mesh elements of each type
+  size_t nHalfedges() const;
+  size_t nVertices() const;
+  size_t nFaces() const;
+
+  // == Navigation (all of these are O(1))
+  static size_t heNext(size_t iHe);     // he.next()
+  static size_t hePrev(size_t iHe);     // he.prev()
+  static size_t heFace(size_t iHe);     // he.face()
+  static size_t fHalfedge(size_t iF);   // f.halfedge()
+  size_t heVertex(size_t iHe) const;    // he.vertex(), the tail of the halfedge
+  size_t heTipVertex(size_t iHe) const; // the tip of the halfedge
+  size_t heTwin(size_t iHe) const;      // he.twin(), or INVALID_IND if the halfedge is on the boundary
+  size_t vHalfedge(size_t iV) const;    // v.halfedge(), an outgoing halfedge (see below)
+
+  // For a boundary vertex, vHalfedge() is always the outgoing halfedge along the boundary (so heTwin() is INVALID_IND),
+  // and the outgoing halfedges can be visited by repeatedly applying vNextOutgoing() until it returns INVALID_IND. For
+  // an interior vertex, vNextOutgoing() cycles back around to vHalfedge().
+  size_t vNextOutgoing(size_t iHe) const;
+
+  bool heIsBoundary(size_t iHe) const;
+  bool vertexIsBoundary(size_t iV) const;
+
+  // == Mutation routines
+  // These keep vertex, face and halfedge indices of existing elements valid; new elements are appended at the end.
+
+  // Flip an edge, given either of its halfedges. Returns true if the edge was flipped; does nothing and returns false
+  // if the edge is on the boundary or the flip would create a degenerate face.
+  bool flip(size_t iHe);
+
+  // Split an edge, given either of its halfedges, inserting a new vertex and splitting each neighboring face in two.
+  // Returns the index of the new vertex.
+  size_t splitEdge(size_t iHe);
+
+  // Insert a new vertex in a face, splitting the face in three. Returns the index of the new vertex.
+  size_t insertVertex(size_t iF);
+
+  // == Utility functions
+  std::vector<std::array<size_t, 3>> getFaceVertexList() const;
+  std::unique_ptr<HalfedgeMesh> toHalfedgeMesh() const;
+
+  // Performs a sanity checks on the connectivity; throws on fail
+  void validateConnectivity() const;
+
+private:
+  // = Core arrays which hold the connectivity
+  std::vector<size_t> heVertexArr;  // he.vertex()
+  std::vector<size_t> heTwinArr;    // he.twin()
+  std::vector<size_t> vHalfedgeArr; // v.halfedge()
+
+  // Construction helpers, each assumes heVertexArr is already populated
+  void buildTwins(size_t nVertices);
+  void buildVertexHalfedges(size_t nVertices);
+
+  // Set heTwin for a pair of halfedges (either may be INVALID_IND, for the boundary)
+  void setTwins(size_t iHeA, size_t iHeB);
+
+  // Append new elements with invalid data
+  size_t getNewFace(); // returns the new face index; its halfedges are 3*f, 3*f+1, 3*f+2
+  size_t getNewVertex();
+};
+
+} // namespace surface
+} // namespace geometrycentral
+
+#include "geometrycentral/surface/compact_triangle_mesh.ipp"
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace geometrycentral {
+namespace surface {
+
+// clang-format off
+
+// Methods for getting number of mesh elements
+inline size_t CompactTriangleMesh::nHalfedges() const { return heVertexArr.size(); }
+inline size_t CompactTriangleMesh::nVertices()  const { return vHalfedgeArr.size(); }
+inline size_t CompactTriangleMesh::nFaces()     const { return heVertexArr.size() / 3; }
+
+// Implicit relationships
+inline size_t CompactTriangleMesh::heNext(size_t iHe)   { return (iHe % 3 == 2) ? iHe - 2 : iHe + 1; }
+inline size_t CompactTriangleMesh::hePrev(size_t iHe)   { return (iHe % 3 == 0) ? iHe + 2 : iHe - 1; }
+inline size_t CompactTriangleMesh::heFace(size_t iHe)   { return iHe / 3; }
+inline size_t CompactTriangleMesh::fHalfedge(size_t iF) { return 3 * iF; }
+
+// Explicit relationships
+inline size_t CompactTriangleMesh::heVertex(size_t iHe)    const { return heVertexArr[iHe]; }
+inline size_t CompactTriangleMesh::heTipVertex(size_t iHe) const { return heVertexArr[heNext(iHe)]; }
+inline size_t CompactTriangleMesh::heTwin(size_t iHe)      const { return heTwinArr[iHe]; }
+inline size_t CompactTriangleMesh::vHalfedge(size_t iV)    const { return vHalfedgeArr[iV]; }
+
+// Other getters
+inline size_t CompactTriangleMesh::vNextOutgoing(size_t iHe) const { return heTwinArr[hePrev(iHe)]; }
+inline bool CompactTriangleMesh::heIsBoundary(size_t iHe)    const { return heTwinArr[iHe] == INVALID_IND; }
+inline bool CompactTriangleMesh::vertexIsBoundary(size_t iV) const { return heIsBoundary(vHalfedgeArr[iV]); }
+
+// clang-format on
+
+} // namespace surface
+} // namespace geometrycentral
@@ -46,7 +46,17 @@ public:
   VertexData<std::array<Vector3,2>> vertexTangentBasis;
   void requireVertexTangentBasis();
   void unrequireVertexTangentBasis();
-  
+
+  // == Incremental updates
+
+  // Update the quantities after the positions of a few vertices have changed (for a VertexPositionGeometry, after
+  // changing inputVertexPositions at those vertices). Unlike refreshQuantities(), which recomputes everything, this
+  // recomputes only the values near the changed vertices for the quantities below, and patches the values of the
+  // Laplacian and mass matrix in place. Any other quantities which have been computed are recomputed from scratch.
+  //   vertexPositions, edgeLengths, faceAreas, vertexDualAreas, cornerAngles, vertexAngleSums, halfedgeCotanWeights,
+  //   edgeCotanWeights, faceNormals, vertexNormals, cotanLaplacian, vertexLumpedMassMatrix
+  void markVerticesChanged(const std::vector<Vertex>& changedVertices);
+
 protected:
 
   // == Implmentations of quantities from base classes
@@ -58,6 +68,9 @@ protected:
   DependentQuantityD<VertexData<Vector3>> vertexPositionsQ;
   virtual void computeVertexPositions() = 0;
 
+  // Recompute vertexPositions at just the given vertices, for markVerticesChanged(). By default, recomputes them all.
+  virtual void updateVertexPositions(const std::vector<Vertex>& changedVertices);
+
   DependentQuantityD<FaceData<Vector3>> faceNormalsQ;
   virtual void computeFaceNormals();
   
@@ -75,6 +88,7 @@ protected:
   virtual void computeCornerAngles() override;
   virtual void computeHalfedgeCotanWeights() override;
   virtual void computeEdgeCotanWeights() override;
+  virtual void computeTriangleQuantities() override;
 };
 
 
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "geometrycentral/surface/halfedge_mesh.h"
+#include "geometrycentral/utilities/vector2.h"
+#include "geometrycentral/utilities/vector3.h"
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include <array>
+
+// === Datatypes which hold vector-valued data on the mesh in a structure-of-arrays layout
+
+namespace geometrycentral {
+namespace surface {
+
+// The scalar components of the types which can be stored by column. Specialized below for Vector2, Vector3, and pairs
+// of Vector3 (like a tangent basis).
+template <typename T>
+struct ColumnLayout {};
+
+template <>
+struct ColumnLayout<Vector2> {
+  static const size_t nColumns = 2;
+  static double get(const Vector2& val, size_t c) { return val[c]; }
+  static void set(Vector2& val, size_t c, double x) { val[c] = x; }
+};
+
+template <>
+struct ColumnLayout<Vector3> {
+  static const size_t nColumns = 3;
+  static double get(const Vector3& val, size_t c) { return val[c]; }
+  static void set(Vector3& val, size_t c, double x) { val[c] = x; }
+};
+
+template <>
+struct ColumnLayout<std::array<Vector3, 2>> {
+  static const size_t nColumns = 6;
+  static double get(const std::array<Vector3, 2>& val, size_t c) { return val[c / 3][c % 3]; }
+  static void set(std::array<Vector3, 2>& val, size_t c, double x) { val[c / 3][c % 3] = x; }
+};
+
+
+// Like MeshData<E,T>, but stores each component of T in its own contiguous array (all the x's, then all the y's, ...)
+// rather than storing an array of T's. Kernels can then stream a whole column at a time, which is what SIMD
+// instructions want. Elements are still accessed with operator[], which assembles a T on read and returns a proxy which
+// scatters on write.
+//
+// Each column is padded to the capacity of the mesh, like the buffer in MeshData<>. When the mesh is compressed, the
+// first size() entries of each column correspond to the elements in order, and column() gives an Eigen view of them.
+template <typename E, typename T>
+class MeshColumnData {
+public:
+  static const size_t nColumns = ColumnLayout<T>::nColumns;
+  typedef std::vector<double, ArenaAllocator<double>> Column;
+
+  // Proxy returned by operator[], which reads and writes a T in the columns
+  class Reference {
+  public:
+    Reference(MeshColumnData<E, T>& parent_, size_t ind_) : parent(parent_), ind(ind_) {}
+    operator T() const;
+    Reference& operator=(const T& val);
+    Reference& operator=(const Reference& other);
+    Reference& operator+=(const T& val);
+    Reference& operator-=(const T& val);
+
+  private:
+    MeshColumnData<E, T>& parent;
+    size_t ind;
+  };
+
+  MeshColumnData();
+  MeshColumnData(HalfedgeMesh& parentMesh);
+  MeshColumnData(HalfedgeMesh& parentMesh, T initVal);
+  MeshColumnData(const MeshData<E, T>& other); // convert from the usual array-of-structs layout
+
+  // Rule of 5
+  MeshColumnData(const MeshColumnData<E, T>& other);
+  MeshColumnData(MeshColumnData<E, T>&& other) noexcept;
+  MeshColumnData<E, T>& operator=(const MeshColumnData<E, T>& other);
+  MeshColumnData<E, T>& operator=(MeshColumnData<E, T>&& other) noexcept;
+  ~MeshColumnData();
+
+  // Access with an element pointer
+  Reference operator[](E e);
+  T operator[](E e) const;
+
+  // Access with an index. The underlying mesh must be compressed.
+  Reference operator[](size_t i);
+  T operator[](size_t i) const;
+
+  // Get the size of the container
+  // (note: logical size, like nVertices(), not actual size of the columns)
+  size_t size() const;
+
+  // Fill with some value
+  void fill(T val);
+
+  // Views of the c'th column, with one entry per element. The underlying mesh must be compressed.
+  Eigen::Map<Eigen::VectorXd, Eigen::Aligned16> column(size_t c);
+  Eigen::Map<const Eigen::VectorXd, Eigen::Aligned16> column(size_t c) const;
+
+  // Raw pointer to the c'th column, indexed like dataIndexOfElement()
+  double* columnData(size_t c);
+  const double* columnData(size_t c) const;
+
+  // Convert to the usual array-of-structs layout
+  MeshData<E, T> toMeshData() const;
+
+  // Register a container created on a frozen mesh after all, as in MeshData<>::thaw()
+  void thaw();
+
+protected:
+  HalfedgeMesh* mesh = nullptr;
+  T defaultValue = T();
+  std::array<Column, nColumns> columns;
+
+  // Callbacks which keep the container valid as the mesh changes, as in MeshData<>
+  std::list<std::function<void(size_t)>>::iterator expandCallbackIt;
+  std::list<std::function<void(const std::vector<size_t>&)>>::iterator permuteCallbackIt;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>::iterator moveCallbackIt;
+  std::list<std::function<void()>>::iterator deleteCallbackIt;
+  std::shared_ptr<void> frozenToken;
+  void registerWithMesh();
+  void registerCallbacks();
+  void deregisterWithMesh();
+
+  T get(size_t i) const;
+  void set(size_t i, const T& val);
+};
+
+// === Typdefs for the usual VertexColumnData<> etc
+template <typename T>
+using VertexColumnData = MeshColumnData<Vertex, T>;
+
+template <typename T>
+using FaceColumnData = MeshColumnData<Face, T>;
+
+template <typename T>
+using EdgeColumnData = MeshColumnData<Edge, T>;
+
+template <typename T>
+using HalfedgeColumnData = MeshColumnData<Halfedge, T>;
+
+template <typename T>
+using CornerColumnData = MeshColumnData<Corner, T>;
+
+} // namespace surface
+} // namespace geometrycentral
+
+#include "geometrycentral/surface/halfedge_column_containers.ipp"
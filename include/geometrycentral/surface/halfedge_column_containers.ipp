@@ -0,0 +1,294 @@
+#pragma once
+
+// === Implementations for datatypes which hold vector-valued data on the mesh in a structure-of-arrays layout
+
+namespace geometrycentral {
+namespace surface {
+
+// === Element proxy
+
+template <typename E, typename T>
+inline MeshColumnData<E, T>::Reference::operator T() const {
+  return parent.get(ind);
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference& MeshColumnData<E, T>::Reference::operator=(const T& val) {
+  parent.set(ind, val);
+  return *this;
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference& MeshColumnData<E, T>::Reference::operator=(const Reference& other) {
+  parent.set(ind, static_cast<T>(other));
+  return *this;
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference& MeshColumnData<E, T>::Reference::operator+=(const T& val) {
+  for (size_t c = 0; c < nColumns; c++) {
+    parent.columns[c][ind] += ColumnLayout<T>::get(val, c);
+  }
+  return *this;
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference& MeshColumnData<E, T>::Reference::operator-=(const T& val) {
+  for (size_t c = 0; c < nColumns; c++) {
+    parent.columns[c][ind] -= ColumnLayout<T>::get(val, c);
+  }
+  return *this;
+}
+
+// === Container
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData() {}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData(HalfedgeMesh& parentMesh) : mesh(&parentMesh) {
+  for (Column& col : columns) {
+    col.resize(elementCapacity<E>(mesh));
+  }
+  fill(defaultValue);
+
+  registerWithMesh();
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData(HalfedgeMesh& parentMesh, T initVal) : mesh(&parentMesh), defaultValue(initVal) {
+  for (Column& col : columns) {
+    col.resize(elementCapacity<E>(mesh));
+  }
+  fill(defaultValue);
+
+  registerWithMesh();
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData(const MeshData<E, T>& other) : MeshColumnData(*other.getMesh()) {
+  for (E e : iterateElements<E>(mesh)) {
+    set(dataIndexOfElement(mesh, e), other[e]);
+  }
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData(const MeshColumnData<E, T>& other)
+    : mesh(other.mesh), defaultValue(other.defaultValue), columns(other.columns) {
+  registerWithMesh();
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::MeshColumnData(MeshColumnData<E, T>&& other) noexcept
+    : mesh(other.mesh), defaultValue(other.defaultValue), columns(std::move(other.columns)) {
+  registerWithMesh();
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>& MeshColumnData<E, T>::operator=(const MeshColumnData<E, T>& other) {
+  deregisterWithMesh();
+  mesh = other.mesh;
+  defaultValue = other.defaultValue;
+  columns = other.columns;
+  registerWithMesh();
+
+  return *this;
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>& MeshColumnData<E, T>::operator=(MeshColumnData<E, T>&& other) noexcept {
+  deregisterWithMesh();
+  mesh = other.mesh;
+  defaultValue = other.defaultValue;
+  columns = std::move(other.columns);
+  registerWithMesh();
+
+  return *this;
+}
+
+template <typename E, typename T>
+MeshColumnData<E, T>::~MeshColumnData() {
+  deregisterWithMesh();
+}
+
+template <typename E, typename T>
+void MeshColumnData<E, T>::registerWithMesh() {
+
+  // Used during default initialization
+  if (mesh == nullptr) return;
+
+  // A frozen mesh will not change, so there is nothing to register
+  if (mesh->isFrozen()) {
+    frozenToken = mesh->frozenContainerToken;
+    return;
+  }
+
+  registerCallbacks();
+}
+
+template <typename E, typename T>
+void MeshColumnData<E, T>::registerCallbacks() {
+
+  // Callback function on expansion
+  std::function<void(size_t)> expandFunc = [this](size_t newSize) {
+    for (size_t c = 0; c < nColumns; c++) {
+      columns[c].resize(newSize, ColumnLayout<T>::get(defaultValue, c));
+    }
+  };
+
+  // Callback function on compression
+  std::function<void(const std::vector<size_t>&)> permuteFunc = [this](const std::vector<size_t>& perm) {
+    for (Column& col : columns) {
+      col = applyPermutation(col, perm);
+    }
+  };
+
+  // Callback function on incremental compression
+  std::function<void(const std::vector<std::pair<size_t, size_t>>&)> moveFunc =
+      [this](const std::vector<std::pair<size_t, size_t>>& moves) {
+        for (Column& col : columns) {
+          for (const std::pair<size_t, size_t>& m : moves) {
+            col[m.second] = col[m.first];
+          }
+        }
+      };
+
+  // Callback function on mesh delete
+  std::function<void()> deleteFunc = [this]() {
+    // Ensures that we don't try to remove with iterators on deconstruct of this object
+    mesh = nullptr;
+  };
+
+  std::unique_lock<std::mutex> lock = mesh->lockCallbacks();
+  expandCallbackIt = insertCallback(getExpandCallbackList<E>(mesh), getExpandCallbackList<E>(mesh).begin(),
+                                    mesh->spareExpandCallbacks, std::move(expandFunc));
+  permuteCallbackIt = insertCallback(getPermuteCallbackList<E>(mesh), getPermuteCallbackList<E>(mesh).end(),
+                                     mesh->sparePermuteCallbacks, std::move(permuteFunc));
+  moveCallbackIt = insertCallback(getMoveCallbackList<E>(mesh), getMoveCallbackList<E>(mesh).end(),
+                                  mesh->spareMoveCallbacks, std::move(moveFunc));
+  deleteCallbackIt = insertCallback(mesh->meshDeleteCallbackList, mesh->meshDeleteCallbackList.end(),
+                                    mesh->spareDeleteCallbacks, std::move(deleteFunc));
+}
+
+template <typename E, typename T>
+void MeshColumnData<E, T>::thaw() {
+  if (frozenToken == nullptr) return;
+  frozenToken.reset();
+  registerCallbacks();
+}
+
+template <typename E, typename T>
+void MeshColumnData<E, T>::deregisterWithMesh() {
+
+  // Used during destruction of default-initializated object, for instance
+  if (mesh == nullptr) return;
+
+  // Never registered, since the mesh was frozen (which may have since been deleted, so don't touch it)
+  if (frozenToken != nullptr) {
+    frozenToken.reset();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock = mesh->lockCallbacks();
+  eraseCallback(getExpandCallbackList<E>(mesh), expandCallbackIt, mesh->spareExpandCallbacks);
+  eraseCallback(getPermuteCallbackList<E>(mesh), permuteCallbackIt, mesh->sparePermuteCallbacks);
+  eraseCallback(getMoveCallbackList<E>(mesh), moveCallbackIt, mesh->spareMoveCallbacks);
+  eraseCallback(mesh->meshDeleteCallbackList, deleteCallbackIt, mesh->spareDeleteCallbacks);
+}
+
+template <typename E, typename T>
+inline T MeshColumnData<E, T>::get(size_t i) const {
+  T val;
+  for (size_t c = 0; c < nColumns; c++) {
+    ColumnLayout<T>::set(val, c, columns[c][i]);
+  }
+  return val;
+}
+
+template <typename E, typename T>
+inline void MeshColumnData<E, T>::set(size_t i, const T& val) {
+  for (size_t c = 0; c < nColumns; c++) {
+    columns[c][i] = ColumnLayout<T>::get(val, c);
+  }
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference MeshColumnData<E, T>::operator[](E e) {
+#ifndef NDEBUG
+  assert(mesh != nullptr && "MeshColumnData is uninitialized.");
+  assert(e.getMesh() == mesh && "Attempted to access MeshColumnData with member from wrong mesh");
+#endif
+  return Reference(*this, dataIndexOfElement(mesh, e));
+}
+
+template <typename E, typename T>
+inline T MeshColumnData<E, T>::operator[](E e) const {
+#ifndef NDEBUG
+  assert(mesh != nullptr && "MeshColumnData is uninitialized.");
+  assert(e.getMesh() == mesh && "Attempted to access MeshColumnData with member from wrong mesh");
+#endif
+  return get(dataIndexOfElement(mesh, e));
+}
+
+template <typename E, typename T>
+inline typename MeshColumnData<E, T>::Reference MeshColumnData<E, T>::operator[](size_t i) {
+#ifndef NDEBUG
+  assert(i < size() && "Attempted to access MeshColumnData with out of bounds index");
+#endif
+  return Reference(*this, i);
+}
+
+template <typename E, typename T>
+inline T MeshColumnData<E, T>::operator[](size_t i) const {
+#ifndef NDEBUG
+  assert(i < size() && "Attempted to access MeshColumnData with out of bounds index");
+#endif
+  return get(i);
+}
+
+template <typename E, typename T>
+inline size_t MeshColumnData<E, T>::size() const {
+  if (mesh == nullptr) return 0;
+  return nElements<E>(mesh);
+}
+
+template <typename E, typename T>
+void MeshColumnData<E, T>::fill(T val) {
+  for (size_t c = 0; c < nColumns; c++) {
+    std::fill(columns[c].begin(), columns[c].end(), ColumnLayout<T>::get(val, c));
+  }
+}
+
+template <typename E, typename T>
+Eigen::Map<Eigen::VectorXd, Eigen::Aligned16> MeshColumnData<E, T>::column(size_t c) {
+  GC_SAFETY_ASSERT(mesh == nullptr || mesh->isCompressed(), "mesh must be compressed to view columns");
+  return Eigen::Map<Eigen::VectorXd, Eigen::Aligned16>(columns[c].data(), size());
+}
+
+template <typename E, typename T>
+Eigen::Map<const Eigen::VectorXd, Eigen::Aligned16> MeshColumnData<E, T>::column(size_t c) const {
+  GC_SAFETY_ASSERT(mesh == nullptr || mesh->isCompressed(), "mesh must be compressed to view columns");
+  return Eigen::Map<const Eigen::VectorXd, Eigen::Aligned16>(columns[c].data(), size());
+}
+
+template <typename E, typename T>
+inline double* MeshColumnData<E, T>::columnData(size_t c) {
+  return columns[c].data();
+}
+
+template <typename E, typename T>
+inline const double* MeshColumnData<E, T>::columnData(size_t c) const {
+  return columns[c].data();
+}
+
+template <typename E, typename T>
+MeshData<E, T> MeshColumnData<E, T>::toMeshData() const {
+  MeshData<E, T> result(*mesh, defaultValue);
+  for (E e : iterateElements<E>(mesh)) {
+    result[e] = get(dataIndexOfElement(mesh, e));
+  }
+  return result;
+}
+
+} // namespace surface
+} // namespace geometrycentral
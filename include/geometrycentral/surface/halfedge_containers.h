@@ -1,18 +1,49 @@
 #pragma once
 
 #include "geometrycentral/surface/halfedge_element_types.h"
+#include "geometrycentral/utilities/buffer_arena.h"
 #include "geometrycentral/utilities/dependent_quantity.h"
 
 #include <Eigen/Core>
 #include <Eigen/StdVector>
 
+#include <array>
 #include <cassert>
+#include <memory>
+#include <type_traits>
 
 // === Datatypes which hold data stored on the mesh
 
 namespace geometrycentral {
+
+struct Vector2;
+struct Vector3;
+
 namespace surface {
 
+// The scalar type that a container element is made of, for MeshData<>::asMatrix(). Only types listed here (all of whose
+// components are of this scalar type) can be viewed as a matrix; specialize it to enable asMatrix() for another type.
+template <typename T>
+struct MatrixComponentType {
+  typedef void type;
+};
+template <>
+struct MatrixComponentType<double> {
+  typedef double type;
+};
+template <>
+struct MatrixComponentType<Vector2> {
+  typedef double type;
+};
+template <>
+struct MatrixComponentType<Vector3> {
+  typedef double type;
+};
+template <size_t N>
+struct MatrixComponentType<std::array<double, N>> {
+  typedef double type;
+};
+
 
 // Geneneric datatype, specialized as VertexData (etc) below
 // E is the element pointer type (eg Vertex)
@@ -30,10 +61,11 @@ protected:
   // The raw buffer which holds the data.
   // As a mesh is being modified, data.size() might be larger than the number of elements. Don't attempt any direct
   // access to this buffer.
-  // Notice that here we _always_ use Eigen's aligned allocator. This is necessary for std::vectors of fixed-size Eigen
+  // Notice that here we _always_ use an aligned allocator. This is necessary for std::vectors of fixed-size Eigen
   // types (see https://eigen.tuxfamily.org/dox/group__TopicStlContainers.html ). There seems to be no downside to just
-  // using it for all types (???). If anything, alignment may help vectorization.
-  std::vector<T, Eigen::aligned_allocator<T>> data;
+  // using it for all types (???). If anything, alignment may help vectorization. The allocator also draws from the
+  // active BufferArena, if there is one (see buffer_arena.h).
+  std::vector<T, ArenaAllocator<T>> data;
 
   // Mutability behavior:
   // From the user's point of view, this container can always be accessed with a valid element pointer, no matter what
@@ -45,10 +77,18 @@ protected:
   // construction and once on destruction, respectively.
   std::list<std::function<void(size_t)>>::iterator expandCallbackIt;
   std::list<std::function<void(const std::vector<size_t>&)>>::iterator permuteCallbackIt;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>::iterator moveCallbackIt;
   std::list<std::function<void()>>::iterator deleteCallbackIt;
   void registerWithMesh();
+  void registerCallbacks();
   void deregisterWithMesh();
 
+  // Held instead of callbacks when the container was created on a frozen mesh (see HalfedgeMesh::freeze())
+  std::shared_ptr<void> frozenToken;
+
+  // Is the i'th element stored at data[i], so the buffer can be used directly as a vector?
+  bool hasDenseIndices() const;
+
 public:
   MeshData();
   MeshData(HalfedgeMesh& parentMesh);
@@ -77,6 +117,9 @@ public:
   // (note: logical size, like nVertices(), not actual size of vector buffer)
   size_t size() const;
 
+  // Get the mesh on which the container is defined
+  HalfedgeMesh* getMesh() const;
+
   // Fill with some value
   void fill(T val);
 
@@ -84,12 +127,27 @@ public:
   // Essentially resets to MeshData<>(), can no longer be used to hold data.
   void clear();
 
+  // A container created on a frozen mesh does not register its callbacks (see HalfedgeMesh::freeze()). This registers
+  // them after all, so the container may outlive the frozen state. Call it while the mesh is still frozen; it does
+  // nothing for a container which is already registered.
+  void thaw();
+
   // Convert to and from (Eigen) vector types
   Eigen::Matrix<T, Eigen::Dynamic, 1> toVector() const;
   Eigen::Matrix<T, Eigen::Dynamic, 1> toVector(const MeshData<E, size_t>& indexer) const;
   void fromVector(const Eigen::Matrix<T, Eigen::Dynamic, 1>& vector);
   void fromVector(const Eigen::Matrix<T, Eigen::Dynamic, 1>& vector, const MeshData<E, size_t>& indexer);
 
+  // Views of the underlying buffer as an (Eigen) vector, without copying. Entry i holds the data for the i'th element,
+  // so the mesh must be compressed (and, for corners, have no boundary). Any mesh mutation invalidates the view.
+  Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>> asVector();
+  Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>> asVector() const;
+
+  // Like asVector(), but for types made of a fixed number of doubles (like Vector3 or Vector2, see MatrixComponentType),
+  // viewed as a matrix with one row per element and one column per component. VertexData<Vector3> gives an N x 3 matrix of positions.
+  Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> asMatrix();
+  Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> asMatrix() const;
+
   // Naively reinterpret the data as residing on another mesh, constructing a new container
   MeshData<E, T> reinterpretTo(HalfedgeMesh& targetMesh);
 };
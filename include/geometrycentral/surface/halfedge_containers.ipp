@@ -5,6 +5,28 @@
 namespace geometrycentral {
 namespace surface {
 
+// === Callback registration helpers
+
+// Insert a callback into a list before pos, reusing a node from spares if there is one
+template <typename F>
+typename std::list<F>::iterator insertCallback(std::list<F>& list, typename std::list<F>::iterator pos,
+                                               std::list<F>& spares, F&& f) {
+  if (spares.empty()) {
+    return list.insert(pos, std::move(f));
+  }
+  typename std::list<F>::iterator it = spares.begin();
+  list.splice(pos, spares, it);
+  *it = std::move(f);
+  return it;
+}
+
+// Remove a callback from a list, keeping its node in spares
+template <typename F>
+void eraseCallback(std::list<F>& list, typename std::list<F>::iterator it, std::list<F>& spares) {
+  *it = nullptr; // release the callback's state now, rather than whenever the node is reused
+  spares.splice(spares.begin(), list, it);
+}
+
 // === Actual function implementations
 
 template <typename E, typename T>
@@ -85,6 +107,18 @@ void MeshData<E, T>::registerWithMesh() {
   // Used during default initialization
   if (mesh == nullptr) return;
 
+  // A frozen mesh will not change, so there is nothing to register
+  if (mesh->isFrozen()) {
+    frozenToken = mesh->frozenContainerToken;
+    return;
+  }
+
+  registerCallbacks();
+}
+
+template <typename E, typename T>
+void MeshData<E, T>::registerCallbacks() {
+
   // Callback function on expansion
   std::function<void(size_t)> expandFunc = [&](size_t newSize) {
     size_t oldSize = data.size();
@@ -101,15 +135,37 @@ void MeshData<E, T>::registerWithMesh() {
   };
 
 
+  // Callback function on incremental compression
+  std::function<void(const std::vector<std::pair<size_t, size_t>>&)> moveFunc =
+      [this](const std::vector<std::pair<size_t, size_t>>& moves) {
+        for (const std::pair<size_t, size_t>& m : moves) {
+          data[m.second] = data[m.first];
+        }
+      };
+
+
   // Callback function on mesh delete
   std::function<void()> deleteFunc = [this]() {
     // Ensures that we don't try to remove with iterators on deconstruct of this object
     mesh = nullptr;
   };
 
-  expandCallbackIt = getExpandCallbackList<E>(mesh).insert(getExpandCallbackList<E>(mesh).begin(), expandFunc);
-  permuteCallbackIt = getPermuteCallbackList<E>(mesh).insert(getPermuteCallbackList<E>(mesh).end(), permuteFunc);
-  deleteCallbackIt = mesh->meshDeleteCallbackList.insert(mesh->meshDeleteCallbackList.end(), deleteFunc);
+  std::unique_lock<std::mutex> lock = mesh->lockCallbacks();
+  expandCallbackIt = insertCallback(getExpandCallbackList<E>(mesh), getExpandCallbackList<E>(mesh).begin(),
+                                    mesh->spareExpandCallbacks, std::move(expandFunc));
+  permuteCallbackIt = insertCallback(getPermuteCallbackList<E>(mesh), getPermuteCallbackList<E>(mesh).end(),
+                                     mesh->sparePermuteCallbacks, std::move(permuteFunc));
+  moveCallbackIt = insertCallback(getMoveCallbackList<E>(mesh), getMoveCallbackList<E>(mesh).end(),
+                                  mesh->spareMoveCallbacks, std::move(moveFunc));
+  deleteCallbackIt = insertCallback(mesh->meshDeleteCallbackList, mesh->meshDeleteCallbackList.end(),
+                                    mesh->spareDeleteCallbacks, std::move(deleteFunc));
+}
+
+template <typename E, typename T>
+void MeshData<E, T>::thaw() {
+  if (frozenToken == nullptr) return;
+  frozenToken.reset();
+  registerCallbacks();
 }
 
 template <typename E, typename T>
@@ -118,9 +174,17 @@ void MeshData<E, T>::deregisterWithMesh() {
   // Used during destruction of default-initializated object, for instance
   if (mesh == nullptr) return;
 
-  getExpandCallbackList<E>(mesh).erase(expandCallbackIt);
-  getPermuteCallbackList<E>(mesh).erase(permuteCallbackIt);
-  mesh->meshDeleteCallbackList.erase(deleteCallbackIt);
+  // Never registered, since the mesh was frozen (which may have since been deleted, so don't touch it)
+  if (frozenToken != nullptr) {
+    frozenToken.reset();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock = mesh->lockCallbacks();
+  eraseCallback(getExpandCallbackList<E>(mesh), expandCallbackIt, mesh->spareExpandCallbacks);
+  eraseCallback(getPermuteCallbackList<E>(mesh), permuteCallbackIt, mesh->sparePermuteCallbacks);
+  eraseCallback(getMoveCallbackList<E>(mesh), moveCallbackIt, mesh->spareMoveCallbacks);
+  eraseCallback(mesh->meshDeleteCallbackList, deleteCallbackIt, mesh->spareDeleteCallbacks);
 }
 
 template <typename E, typename T>
@@ -136,8 +200,20 @@ inline void MeshData<E, T>::clear() {
   data.clear();
 }
 
+template <typename E, typename T>
+bool MeshData<E, T>::hasDenseIndices() const {
+  if (!mesh->isCompressed()) return false;
+
+  // Corners are indexed like halfedges, so exterior halfedges leave gaps
+  if (std::is_same<E, Corner>::value && mesh->hasBoundary()) return false;
+
+  return true;
+}
+
 template <typename E, typename T>
 Eigen::Matrix<T, Eigen::Dynamic, 1> MeshData<E, T>::toVector() const {
+  if (hasDenseIndices()) return asVector();
+
   Eigen::Matrix<T, Eigen::Dynamic, 1> result(nElements<E>(mesh));
   size_t i = 0;
   for (E e : iterateElements<E>(mesh)) {
@@ -165,6 +241,10 @@ Eigen::Matrix<T, Eigen::Dynamic, 1> MeshData<E, T>::toVector(const MeshData<E, s
 template <typename E, typename T>
 void MeshData<E, T>::fromVector(const Eigen::Matrix<T, Eigen::Dynamic, 1>& vector) {
   if ((size_t)vector.rows() != nElements<E>(mesh)) throw std::runtime_error("Vector size does not match mesh size.");
+  if (hasDenseIndices()) {
+    asVector() = vector;
+    return;
+  }
   size_t i = 0;
   for (E e : iterateElements<E>(mesh)) {
     (*this)[e] = vector(i);
@@ -181,6 +261,41 @@ void MeshData<E, T>::fromVector(const Eigen::Matrix<T, Eigen::Dynamic, 1>& vecto
   }
 }
 
+template <typename E, typename T>
+Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>> MeshData<E, T>::asVector() {
+  GC_SAFETY_ASSERT(hasDenseIndices(), "mesh must be compressed to view data as a vector");
+  return Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(data.data(), nElements<E>(mesh));
+}
+
+template <typename E, typename T>
+Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>> MeshData<E, T>::asVector() const {
+  GC_SAFETY_ASSERT(hasDenseIndices(), "mesh must be compressed to view data as a vector");
+  return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(data.data(), nElements<E>(mesh));
+}
+
+template <typename E, typename T>
+Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> MeshData<E, T>::asMatrix() {
+  static_assert(std::is_same<typename MatrixComponentType<T>::type, double>::value,
+                "asMatrix() requires a type made of doubles (see MatrixComponentType)");
+  static_assert(std::is_trivially_copyable<T>::value && sizeof(T) % sizeof(double) == 0,
+                "asMatrix() requires a type made of doubles");
+  GC_SAFETY_ASSERT(hasDenseIndices(), "mesh must be compressed to view data as a matrix");
+  return Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+      reinterpret_cast<double*>(data.data()), nElements<E>(mesh), sizeof(T) / sizeof(double));
+}
+
+template <typename E, typename T>
+Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+MeshData<E, T>::asMatrix() const {
+  static_assert(std::is_same<typename MatrixComponentType<T>::type, double>::value,
+                "asMatrix() requires a type made of doubles (see MatrixComponentType)");
+  static_assert(std::is_trivially_copyable<T>::value && sizeof(T) % sizeof(double) == 0,
+                "asMatrix() requires a type made of doubles");
+  GC_SAFETY_ASSERT(hasDenseIndices(), "mesh must be compressed to view data as a matrix");
+  return Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+      reinterpret_cast<const double*>(data.data()), nElements<E>(mesh), sizeof(T) / sizeof(double));
+}
+
 template <typename E, typename T>
 inline T& MeshData<E, T>::operator[](E e) {
 #ifndef NDEBUG
@@ -226,6 +341,11 @@ inline size_t MeshData<E, T>::size() const {
 }
 
 
+template <typename E, typename T>
+inline HalfedgeMesh* MeshData<E, T>::getMesh() const {
+  return mesh;
+}
+
 template <typename E, typename T>
 inline MeshData<E, T> MeshData<E, T>::reinterpretTo(HalfedgeMesh& targetMesh) {
   GC_SAFETY_ASSERT(nElements<E>(mesh) == nElements<E>(&targetMesh),
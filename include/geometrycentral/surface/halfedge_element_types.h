@@ -2,16 +2,21 @@
 
 #include "geometrycentral/utilities/utilities.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace geometrycentral {
 namespace surface {
 
 // === Types and inline methods for the halfedge mesh pointer and datatypes
 class HalfedgeMesh;
+class DynamicElementRegistry;
 
 
 // === Types for mesh elements
@@ -71,6 +76,10 @@ template <typename E> std::list<std::function<void(size_t)>>& getExpandCallbackL
 
 template <typename E> std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList(HalfedgeMesh* mesh);
 
+template <typename E> std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList(HalfedgeMesh* mesh);
+
+template <typename E> DynamicElementRegistry& getDynamicElementRegistry(HalfedgeMesh* mesh);
+
 template <typename E> std::string typeShortName() { return "X"; }
 // clang-format on
 
@@ -154,15 +163,47 @@ public:
   // returns a new plain old static element. Useful for chaining.
   S decay() const;
 
+  // An element created on a frozen mesh does not register with it (see HalfedgeMesh::freeze()). This registers it after
+  // all, so it may outlive the frozen state. Call it while the mesh is still frozen.
+  void thaw();
+
 private:
-  // References to the callbacks which keep the element valid. Keep these around to de-register on destruction.
-  std::list<std::function<void(const std::vector<size_t>&)>>::iterator permuteCallbackIt;
-  std::list<std::function<void()>>::iterator deleteCallbackIt;
+  // Our slot in the mesh's registry of dynamic elements, which keeps the element valid. Keep this around to de-register
+  // on destruction.
+  size_t registrySlot = INVALID_IND;
+
+  // Held instead of a registry slot when the element was created on a frozen mesh, so that the mesh cannot be unfrozen
+  // (and then re-indexed) while the element is alive
+  std::shared_ptr<void> frozenToken;
 
   void registerWithMesh();
   void deregisterWithMesh();
 };
 
+// == Registry of all the dynamic elements of one type on a mesh.
+// Each registered element occupies a slot holding pointers to its mesh and index. When the mesh permutes its elements,
+// every slot is remapped in a single pass using one shared inverse permutation, so updating k dynamic elements costs
+// O(k) on top of the O(n) work the mesh does anyway (rather than each element searching the permutation). Freed slots
+// are recycled, so registering and de-registering are O(1).
+class DynamicElementRegistry {
+public:
+  size_t add(HalfedgeMesh** meshPtr, size_t* indPtr); // returns the slot
+  void remove(size_t slot);
+  bool empty() const;
+
+  void permute(const std::vector<size_t>& oldToNew); // remap every element such that ind_new = oldToNew[ind_old]
+  void move(const std::vector<std::pair<size_t, size_t>>& moves); // remap elements by (from, to) pairs
+  void detachAll(); // null out the mesh of every element, called when the mesh is deleted
+
+private:
+  struct Slot {
+    HalfedgeMesh** mesh;
+    size_t* ind;
+  };
+  std::vector<Slot> slots;     // nullptr entries are free
+  std::vector<size_t> freeSlots;
+};
+
 
 // == Base range iterator
 // All range iterators have the form "advance through indices, skipping invalid elements". The two classes below
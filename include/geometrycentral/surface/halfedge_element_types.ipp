@@ -92,29 +92,96 @@ DynamicElement<S>::~DynamicElement() {
   deregisterWithMesh();
 }
 
+template<typename S> 
+S DynamicElement<S>::decay() const {
+  return S(this->mesh, this->ind);
+}
+
+template<typename S> 
+void DynamicElement<S>::thaw() {
+  if (frozenToken == nullptr) return;
+  frozenToken.reset();
+  std::unique_lock<std::mutex> lock = this->mesh->lockCallbacks();
+  registrySlot = getDynamicElementRegistry<S>(this->mesh).add(&this->mesh, &this->ind);
+}
+
 template<typename S> 
 void DynamicElement<S>::registerWithMesh() {
-  
-  // Callback function on permutation
-  std::function<void(const std::vector<size_t>&)> permuteFunc = [this](const std::vector<size_t>& perm) {
-    // TODO FIXME not implemented. See note in mesh compression callbacks.
-  };
+  if (this->mesh == nullptr) return;
 
-  // Callback function on mesh delete
-  std::function<void()> deleteFunc = [this]() {
-    // Ensures that we don't try to remove with iterators on deconstruct of this object
-    this->mesh = nullptr;
-  };
+  // A frozen mesh will not change, so there is nothing to register
+  if (this->mesh->isFrozen()) {
+    frozenToken = this->mesh->frozenContainerToken;
+    return;
+  }
 
-  permuteCallbackIt = getPermuteCallbackList<S>(this->mesh).insert(getPermuteCallbackList<S>(this->mesh).end(), permuteFunc);
-  deleteCallbackIt = this->mesh->meshDeleteCallbackList.insert(this->mesh->meshDeleteCallbackList.end(), deleteFunc);
+  std::unique_lock<std::mutex> lock = this->mesh->lockCallbacks();
+  registrySlot = getDynamicElementRegistry<S>(this->mesh).add(&this->mesh, &this->ind);
 }
 
 template<typename S> 
 void DynamicElement<S>::deregisterWithMesh() {
-  if (this->mesh == nullptr) return;
-  getPermuteCallbackList<S>(this->mesh).erase(permuteCallbackIt);
-  this->mesh->meshDeleteCallbackList.erase(deleteCallbackIt);
+  // Never registered, since the mesh was frozen (which may have since been deleted, so don't touch it)
+  if (frozenToken != nullptr) {
+    frozenToken.reset();
+    return;
+  }
+
+  // (the mesh is nulled out by the registry if it is deleted first)
+  if (this->mesh == nullptr || registrySlot == INVALID_IND) return;
+  std::unique_lock<std::mutex> lock = this->mesh->lockCallbacks();
+  getDynamicElementRegistry<S>(this->mesh).remove(registrySlot);
+  registrySlot = INVALID_IND;
+}
+
+// Dynamic element registry
+inline size_t DynamicElementRegistry::add(HalfedgeMesh** meshPtr, size_t* indPtr) {
+  if (freeSlots.empty()) {
+    slots.push_back(Slot{meshPtr, indPtr});
+    return slots.size() - 1;
+  }
+  size_t slot = freeSlots.back();
+  freeSlots.pop_back();
+  slots[slot] = Slot{meshPtr, indPtr};
+  return slot;
+}
+
+inline void DynamicElementRegistry::remove(size_t slot) {
+  slots[slot] = Slot{nullptr, nullptr};
+  freeSlots.push_back(slot);
+}
+
+inline bool DynamicElementRegistry::empty() const { return slots.size() == freeSlots.size(); }
+
+inline void DynamicElementRegistry::permute(const std::vector<size_t>& oldToNew) {
+  for (Slot& s : slots) {
+    if (s.ind != nullptr && *s.ind != INVALID_IND) {
+      *s.ind = oldToNew[*s.ind];
+    }
+  }
+}
+
+inline void DynamicElementRegistry::move(const std::vector<std::pair<size_t, size_t>>& moves) {
+  if (empty() || moves.empty()) return;
+  std::vector<std::pair<size_t, size_t>> sortedMoves = moves;
+  std::sort(sortedMoves.begin(), sortedMoves.end());
+  for (Slot& s : slots) {
+    if (s.ind == nullptr) continue;
+    auto it = std::lower_bound(sortedMoves.begin(), sortedMoves.end(), std::make_pair(*s.ind, size_t(0)));
+    if (it != sortedMoves.end() && it->first == *s.ind) {
+      *s.ind = it->second;
+    }
+  }
+}
+
+inline void DynamicElementRegistry::detachAll() {
+  for (Slot& s : slots) {
+    if (s.mesh != nullptr) {
+      *s.mesh = nullptr;
+    }
+  }
+  slots.clear();
+  freeSlots.clear();
 }
 
 
@@ -3,6 +3,8 @@
 #include "geometrycentral/surface/vertex_position_geometry.h"
 #include "geometrycentral/surface/halfedge_mesh.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <tuple>
 
@@ -22,5 +24,17 @@ std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry
 makeHalfedgeAndGeometry(const std::vector<std::vector<size_t>>& polygons, const std::vector<Vector3> vertexPositions,
                         bool compressIndices = true, bool verbose = false);
 
+// Same as above, from a flat face list (see the corresponding HalfedgeMesh constructor). T may be size_t or uint32_t.
+template <typename T>
+std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<T>& faceIndices, const std::vector<size_t>& faceStart,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices = true, bool verbose = false);
+
+// Same as above, from a list of triangles. T may be size_t or uint32_t.
+template <typename T>
+std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<std::array<T, 3>>& triangles, const std::vector<Vector3>& vertexPositions,
+                        bool compressIndices = true, bool verbose = false);
+
 } // namespace surface
 } // namespace geometrycentral
@@ -54,7 +54,21 @@ template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& ge
 template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList<Corner       >(HalfedgeMesh* mesh)   { return mesh->halfedgePermuteCallbackList;   }
 template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList<Edge         >(HalfedgeMesh* mesh)   { return mesh->edgePermuteCallbackList;   }
 template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList<Face         >(HalfedgeMesh* mesh)   { return mesh->facePermuteCallbackList;   }
-template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList<BoundaryLoop >(HalfedgeMesh* mesh)   { return mesh->facePermuteCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<size_t>&)>>& getPermuteCallbackList<BoundaryLoop >(HalfedgeMesh* mesh)   { return mesh->boundaryLoopPermuteCallbackList;   }
+
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<Vertex       >(HalfedgeMesh* mesh)   { return mesh->vertexMoveCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<Halfedge     >(HalfedgeMesh* mesh)   { return mesh->halfedgeMoveCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<Corner       >(HalfedgeMesh* mesh)   { return mesh->halfedgeMoveCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<Edge         >(HalfedgeMesh* mesh)   { return mesh->edgeMoveCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<Face         >(HalfedgeMesh* mesh)   { return mesh->faceMoveCallbackList;   }
+template<> inline std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>>& getMoveCallbackList<BoundaryLoop >(HalfedgeMesh* mesh)   { return mesh->boundaryLoopMoveCallbackList;   }
+
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<Vertex       >(HalfedgeMesh* mesh)   { return mesh->vertexDynamicElements;       }
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<Halfedge     >(HalfedgeMesh* mesh)   { return mesh->halfedgeDynamicElements;     }
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<Corner       >(HalfedgeMesh* mesh)   { return mesh->halfedgeDynamicElements;     }
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<Edge         >(HalfedgeMesh* mesh)   { return mesh->edgeDynamicElements;         }
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<Face         >(HalfedgeMesh* mesh)   { return mesh->faceDynamicElements;         }
+template<> inline DynamicElementRegistry& getDynamicElementRegistry<BoundaryLoop >(HalfedgeMesh* mesh)   { return mesh->boundaryLoopDynamicElements; }
 
 template<> inline std::string typeShortName<Vertex       >()            { return "v";    }
 template<> inline std::string typeShortName<Halfedge     >()            { return "he";   }
@@ -5,14 +5,77 @@
 #include "geometrycentral/surface/halfedge_iterators.h"
 #include "geometrycentral/utilities/utilities.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
 
 // NOTE: ipp includes at bottom of file
 
 namespace geometrycentral {
 namespace surface {
+
+// The connectivity arrays in HalfedgeMesh hold element indices in an IndexVector. By default this is simply a
+// std::vector<size_t>. If GC_HALFEDGE_32BIT_INDICES is defined (CMake option of the same name), indices are instead
+// stored as uint32_t, which halves the memory used by connectivity, but limits meshes to fewer than 2^32-1 halfedges.
+// INVALID_IND is stored as the largest uint32_t and translated back when read, so the interface is the same.
+#ifdef GC_HALFEDGE_32BIT_INDICES
+class CompactIndexVector {
+public:
+  // Reference to an entry, which reads and writes as a size_t
+  class Reference {
+  public:
+    Reference(uint32_t& val_) : val(val_) {}
+    operator size_t() const { return decode(val); }
+    Reference& operator=(size_t ind) {
+      val = encode(ind);
+      return *this;
+    }
+    Reference& operator=(const Reference& other) {
+      val = other.val;
+      return *this;
+    }
+    Reference& operator+=(size_t delta) { return *this = static_cast<size_t>(*this) + delta; }
+
+  private:
+    uint32_t& val;
+  };
+
+  CompactIndexVector() {}
+  CompactIndexVector(size_t n, size_t ind = 0);
+
+  size_t size() const { return data.size(); }
+  void resize(size_t n);
+  void push_back(size_t ind);
+
+  Reference operator[](size_t i) { return Reference(data[i]); }
+  size_t operator[](size_t i) const { return decode(data[i]); }
+
+private:
+  std::vector<uint32_t> data;
+
+  static const uint32_t INVALID_COMPACT_IND = std::numeric_limits<uint32_t>::max();
+  static uint32_t encode(size_t ind) {
+    return ind == INVALID_IND ? INVALID_COMPACT_IND : static_cast<uint32_t>(ind);
+  }
+  static size_t decode(uint32_t val) { return val == INVALID_COMPACT_IND ? INVALID_IND : val; }
+  static void checkSize(size_t n) {
+    // always checked (even without safety checks), since overflowing would silently truncate indices
+    if (n > INVALID_COMPACT_IND) {
+      throw std::length_error("mesh too large for 32-bit indices (GC_HALFEDGE_32BIT_INDICES)");
+    }
+  }
+};
+typedef CompactIndexVector IndexVector;
+#else
+typedef std::vector<size_t> IndexVector;
+#endif
+
 // Foward declare some return types from below
 // template<typename T> class VertexData;
 // template<> class VertexData<size_t>;
@@ -26,7 +89,22 @@ public:
   // Assumes that the vertex listing in polygons is dense; all indices from [0,MAX_IND) must appear in some face.
   // (some functions, like in meshio.h preprocess inputs to strip out unused indices).
   // The output will preserve the ordering of vertices and faces.
-  HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, bool verbose = false);
+  // Construction runs on up to nThreads threads (0 means one per hardware thread), fewer for small meshes; the result is
+  // identical for any nThreads.
+  HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, bool verbose = false, size_t nThreads = 1);
+
+  // Build a halfedge mesh from a flat face list, where the vertices of face i are
+  // faceIndices[faceStart[i]] ... faceIndices[faceStart[i+1]-1] (so faceStart has one more entry than there are faces).
+  // Avoids allocating a list for each face; otherwise the same as above. T may be size_t or uint32_t.
+  template <typename T>
+  HalfedgeMesh(const std::vector<T>& faceIndices, const std::vector<size_t>& faceStart, bool verbose = false,
+               size_t nThreads = 1);
+
+  // Build a triangle mesh from a list of vertex index triples. Otherwise the same as above.
+  // T may be size_t or uint32_t.
+  template <typename T>
+  HalfedgeMesh(const std::vector<std::array<T, 3>>& triangles, bool verbose = false, size_t nThreads = 1);
+
   ~HalfedgeMesh();
 
 
@@ -87,8 +165,9 @@ public:
   Halfedge connectVertices(Halfedge heA, Halfedge heB);
 
   // Collapse an edge. Returns the vertex adjacent to that edge which still exists. Returns Vertex() if not
-  // collapsible.
-  // Vertex collapseEdge(Edge e); TODO
+  // collapsible. Currently only supports interior edges between triangles, which do not connect two boundary vertices.
+  // Deleted elements are left as tombstones; see compress() and setAutoCompaction().
+  Vertex collapseEdge(Edge e);
 
   // Remove a face which is adjacent to the boundary of the mesh (along with its edge on the boundary).
   // Face must have exactly one boundary edge.
@@ -99,6 +178,32 @@ public:
   // Triangulate in a face, returns all subfaces
   std::vector<Face> triangulate(Face face);
 
+  // Ensure capacity for at least this many vertices, edges and faces in total (not counting boundary loops), so that
+  // mutations can grow the mesh to this size without any further reallocation. Expands the connectivity arrays and
+  // MeshData<> containers at most once each (or defers it to endBatch(), as usual). Never shrinks. Reserves exactly
+  // the requested size, so call it once up front rather than before each mutation.
+  void reserve(size_t nVertices, size_t nEdges, size_t nFaces);
+
+  // Batched mutation. Between beginBatch() and endBatch(), growing the mesh does not invoke the expansion callbacks
+  // below. Instead, endBatch() invokes each list once with the final capacity, so that long sequences of mutations
+  // don't resize every MeshData<> container at each expansion. The catch is that containers do not have entries for
+  // elements created during the batch until it ends, so they must not be accessed for new elements in the meantime.
+  // Batches may be nested; callbacks are invoked when the outermost batch ends.
+  void beginBatch();
+  void endBatch();
+  bool isInBatch() const;
+
+  // Frozen mode, for a mesh which is shared by many threads. A frozen mesh cannot be mutated, so MeshData<> containers
+  // and dynamic elements created on it do not register their callbacks with it, and constructing or destroying them
+  // never modifies the mesh. Any number of threads may then create containers on the mesh concurrently, with no
+  // locking. Containers created while the mesh is frozen must not outlive it, and must be destroyed (or thaw()ed) before
+  // it is unfrozen (unfreeze() throws otherwise). Containers created before the mesh was frozen are still registered, so
+  // destroying or reassigning them takes a lock on the mesh. Dynamic elements created while it is frozen act as plain
+  // elements.
+  void freeze();
+  void unfreeze();
+  bool isFrozen() const;
+
 
   // Methods for obtaining canonical indices for mesh elements
   // (Note that in some situations, custom indices might instead be needed)
@@ -119,16 +224,40 @@ public:
   void printStatistics() const;    // print info about element counts to std::cout
 
   std::vector<std::vector<size_t>> getFaceVertexList();
+  template <typename T> // see constructor; T may be size_t or uint32_t
+  void getFaceVertexListFlat(std::vector<T>& faceIndices, std::vector<size_t>& faceStart);
+  std::vector<std::array<size_t, 3>> getFaceVertexListTriangles(); // mesh must be triangular
   std::unique_ptr<HalfedgeMesh> copy() const;
 
-  // Compress the mesh
+  // Compress the mesh, removing the tombstones left by deleted elements. Preserves the relative order of the remaining
+  // elements.
   bool isCompressed() const;
   void compress();
 
+  // Partially compress the mesh, filling up to maxMoves holes of each element type by moving the elements at the back
+  // of each buffer into them. This does not preserve the order of the elements, but costs O(maxMoves) rather than
+  // O(n). MeshData<> containers and dynamic elements follow the moved elements via the move callbacks below.
+  void compressIncrementally(size_t maxMoves);
+
+  // Compress automatically as the mesh is mutated. After each mutation which deletes elements, fill up to
+  // movesPerMutation holes of each type as in compressIncrementally(), and fully compress() if the fraction of dead
+  // elements in any buffer exceeds tombstoneRatio anyway. When mutating in a batch, this happens in endBatch(). Like
+  // compress(), this re-indexes elements, so only dynamic elements (and the elements returned by mutations) remain
+  // valid. The default of (0, 1.) never compresses automatically.
+  void setAutoCompaction(size_t movesPerMutation, double tombstoneRatio = 1.);
+
   // Canonicalize the element ordering to be the same indexing convention as after construction from polygon soup.
   bool isCanonical() const;
   void canonicalize();
 
+  // Reorder the elements of the mesh, where newToOld[iNew] gives the old index of the element which will have index
+  // iNew, and must be a permutation of [0, nVertices()) (etc). All MeshData<> containers follow along via the permute
+  // callbacks below. Permuting edges moves both of their halfedges. The mesh must be compressed, and not in a batch.
+  // See mesh_ordering.h for orderings which improve memory locality.
+  void permuteVertices(const std::vector<size_t>& newToOld);
+  void permuteEdges(const std::vector<size_t>& newToOld);
+  void permuteFaces(const std::vector<size_t>& newToOld); // boundary loops are not moved
+
   // == Callbacks that will be invoked on mutation to keep containers/iterators/etc valid.
 
   // Expansion callbacks
@@ -140,20 +269,57 @@ public:
   std::list<std::function<void(size_t)>> halfedgeExpandCallbackList;
 
   // Compression callbacks
-  // Argument is a permutation to a apply, such that d_new[i] = d_old[p[i]]
-  // TODO FIXME there's a big problem here, in that this format of callbacks does not allow DynamicElement update in
-  // O(1)
+  // Argument is a permutation to a apply, such that d_new[i] = d_old[p[i]]. The permutation is computed once by the
+  // mesh and shared by all containers. Dynamic elements need the inverse permutation instead, so they are updated via
+  // the registries below rather than through these callbacks.
   // TODO think about capacity rules with callbacks: old rule was that new size may be smaller
   std::list<std::function<void(const std::vector<size_t>&)>> vertexPermuteCallbackList;
   std::list<std::function<void(const std::vector<size_t>&)>> facePermuteCallbackList;
   std::list<std::function<void(const std::vector<size_t>&)>> edgePermuteCallbackList;
   std::list<std::function<void(const std::vector<size_t>&)>> halfedgePermuteCallbackList;
+  std::list<std::function<void(const std::vector<size_t>&)>> boundaryLoopPermuteCallbackList;
+
+  // Dynamic element registries
+  // All of the DynamicElement<>s on the mesh, which are remapped in a single pass on each permutation. Corners share
+  // the halfedge registry, since they have the same indices.
+  DynamicElementRegistry vertexDynamicElements;
+  DynamicElementRegistry halfedgeDynamicElements;
+  DynamicElementRegistry edgeDynamicElements;
+  DynamicElementRegistry faceDynamicElements;
+  DynamicElementRegistry boundaryLoopDynamicElements;
+
+  // Move callbacks
+  // Argument is a list of (from, to) pairs, where the element at index from has moved to index to (which was a dead
+  // element). The elements at the from indices are dead afterwards.
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> vertexMoveCallbackList;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> faceMoveCallbackList;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> edgeMoveCallbackList;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> halfedgeMoveCallbackList;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> boundaryLoopMoveCallbackList;
 
   // Mesh delete callbacks
   // (this unfortunately seems to be necessary; objects which have registered their callbacks above
   // need to know not to try to de-register them if the mesh has been deleted)
   std::list<std::function<void()>> meshDeleteCallbackList;
 
+  // Spare nodes for the callback lists above. Containers recycle their list nodes through these when they deregister, so
+  // constructing and destroying short-lived containers does not allocate once the mesh has warmed up.
+  std::list<std::function<void(size_t)>> spareExpandCallbacks;
+  std::list<std::function<void(const std::vector<size_t>&)>> sparePermuteCallbacks;
+  std::list<std::function<void(const std::vector<std::pair<size_t, size_t>>&)>> spareMoveCallbacks;
+  std::list<std::function<void()>> spareDeleteCallbacks;
+
+  // Shared by every container and dynamic element created while the mesh is frozen (in place of registering), so that
+  // unfreeze() can tell when they are all gone. Null when the mesh is not frozen.
+  std::shared_ptr<void> frozenContainerToken;
+
+  // Containers hold callbackMutex when registering or deregistering their callbacks while the mesh is frozen or
+  // sharedCallbackCount > 0, since any number of threads may then be doing so at once (as when geometry quantities are
+  // computed in parallel, see requireAll(), which increments the count while it runs). Otherwise nothing is locked.
+  std::mutex callbackMutex;
+  std::atomic<size_t> sharedCallbackCount{0};
+  std::unique_lock<std::mutex> lockCallbacks();
+
   // Check capacity. Needed when implementing expandable containers for mutable meshes to ensure the contain can
   // hold a sufficient number of elements before the next resize event.
   size_t nHalfedgesCapacity() const;
@@ -174,11 +340,11 @@ private:
   // Note: it should always be true that heFace.size() == nHalfedgesCapacityCount, but any elements after
   // nHalfedgesFillCount will be valid indices (in the std::vector sense), but contain uninitialized data. Similarly,
   // any std::vector<> indices corresponding to deleted elements will hold meaningless values.
-  std::vector<size_t> heNext;    // he.next()
-  std::vector<size_t> heVertex;  // he.vertex()
-  std::vector<size_t> heFace;    // he.face()
-  std::vector<size_t> vHalfedge; // v.halfedge()
-  std::vector<size_t> fHalfedge; // f.halfedge()
+  IndexVector heNext;    // he.next()
+  IndexVector heVertex;  // he.vertex()
+  IndexVector heFace;    // he.face()
+  IndexVector vHalfedge; // v.halfedge()
+  IndexVector fHalfedge; // f.halfedge()
 
   // Implicit connectivity relationships
   static size_t heTwin(size_t iHe);   // he.twin()
@@ -222,12 +388,35 @@ private:
   bool isCanonicalFlag = true;
   bool isCompressedFlag = true;
 
+  // Batched mutation state, see beginBatch(). The capacities are recorded when the outermost batch begins.
+  size_t batchDepth = 0;
+  size_t batchVerticesCapacityCount = 0;
+  size_t batchHalfedgesCapacityCount = 0;
+  size_t batchFacesCapacityCount = 0;
+
+  // Automatic compaction state, see setAutoCompaction(). The lists hold the indices of deleted elements, which are
+  // filled by compressIncrementally(). They may also hold stale entries (for indices which have since been trimmed
+  // off the end of the buffer or reused), which are skipped.
+  size_t compactionMovesPerMutation = 0;
+  double compactionTombstoneRatio = 1.;
+  std::vector<size_t> deadVertices;
+  std::vector<size_t> deadEdges;
+  std::vector<size_t> deadFaces;
+
   // Hide copy and move constructors, we don't wanna mess with that
   HalfedgeMesh(const HalfedgeMesh& other) = delete;
   HalfedgeMesh& operator=(const HalfedgeMesh& other) = delete;
   HalfedgeMesh(HalfedgeMesh&& other) = delete;
   HalfedgeMesh& operator=(HalfedgeMesh&& other) = delete;
 
+  // Shared implementation of the constructors, generic over the format of the input face list
+  template <typename F>
+  void constructFromFaces(const F& faces, bool verbose, size_t nThreads);
+
+  // Throws if the mesh is frozen. Called by every mutating method; unlike the other validity checks, this one is not
+  // disabled by NGC_SAFTEY_CHECKS, since it is cheap and mutating a mesh shared between threads is a data race.
+  void checkNotFrozen() const;
+
 
   // Implementation note: the getNew() and delete() functions below cannot operate on a single halfedge or edge. We must
   // simultaneously create or delete the triple of an edge and both adjacent halfedges. This constraint arises because
@@ -239,6 +428,11 @@ private:
   Face getNewFace();
   BoundaryLoop getNewBoundaryLoop();
 
+  // Grow the buffers for each element type to the given capacity, and invoke the expansion callbacks
+  void expandVertexCapacity(size_t newCapacity);
+  void expandEdgeCapacity(size_t newEdgeCapacity); // halfedges too, since capacities are kept in sync
+  void expandFaceCapacity(size_t newCapacity);      // includes boundary loops
+
   // Detect dead elements
   bool vertexIsDead(size_t iV) const;
   bool halfedgeIsDead(size_t iHe) const;
@@ -250,14 +444,26 @@ private:
   void deleteEdgeTriple(Halfedge he);
   void deleteElement(Vertex v);
   void deleteElement(Face f);
-  void deleteElement(BoundaryLoop bl);
+
+  // Relabel elements according to a permutation of the whole buffer, such that d_new[i] = d_old[perm[i]], and invoke
+  // the permute callbacks. Dead elements are allowed. Permuting edges moves both of their halfedges.
+  void applyVertexPermutation(const std::vector<size_t>& perm);
+  void applyEdgePermutation(const std::vector<size_t>& edgePerm);
+  void applyFacePermutation(const std::vector<size_t>& perm);
 
   // Compression helpers
-  void compressHalfedges();
   void compressEdges();
   void compressFaces();
   void compressVertices();
 
+  // Move a live element to the index of a dead one, updating the connectivity but invoking no callbacks
+  void moveVertex(size_t iFrom, size_t iTo);
+  void moveEdge(size_t iFrom, size_t iTo); // along with its halfedges
+  void moveFace(size_t iFrom, size_t iTo);
+
+  // Apply the automatic compaction policy, called after mutations which delete elements
+  void compactAfterMutation();
+
 
   // Helpers for mutation methods
   void ensureVertexHasBoundaryHalfedge(Vertex v); // impose invariant that v.halfedge is start of half-disk
@@ -65,10 +65,32 @@ inline BoundaryLoop HalfedgeMesh::boundaryLoop(size_t index) { return BoundaryLo
 
 inline bool HalfedgeMesh::isCompressed() const { return isCompressedFlag; }
 inline bool HalfedgeMesh::isCanonical() const { return isCanonicalFlag; }
+inline bool HalfedgeMesh::isInBatch() const { return batchDepth > 0; }
+inline bool HalfedgeMesh::isFrozen() const { return frozenContainerToken != nullptr; }
+inline std::unique_lock<std::mutex> HalfedgeMesh::lockCallbacks() {
+  if (!isFrozen() && sharedCallbackCount.load() == 0) return std::unique_lock<std::mutex>();
+  return std::unique_lock<std::mutex>(callbackMutex);
+}
 inline bool HalfedgeMesh::hasBoundary() const { return nBoundaryLoopsCount > 0; }
 
 // clang-format on
 
+#ifdef GC_HALFEDGE_32BIT_INDICES
+inline CompactIndexVector::CompactIndexVector(size_t n, size_t ind) {
+  checkSize(n);
+  data.resize(n, encode(ind));
+}
+
+inline void CompactIndexVector::resize(size_t n) {
+  checkSize(n);
+  data.resize(n);
+}
+
+inline void CompactIndexVector::push_back(size_t ind) {
+  checkSize(data.size() + 1);
+  data.push_back(encode(ind));
+}
+#endif
 
 } // namespace surface
 } // namespace geometrycentral
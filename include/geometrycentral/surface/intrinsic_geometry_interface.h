@@ -7,6 +7,8 @@
 #include <Eigen/SparseCore>
 
 #include <complex>
+#include <mutex>
+#include <vector>
 
 namespace geometrycentral {
 namespace surface {
@@ -75,6 +77,13 @@ public:
   void requireEdgeCotanWeights();
   void unrequireEdgeCotanWeights();
 
+  // Triangle quantities
+  // Requires faceAreas, vertexDualAreas, cornerAngles, halfedgeCotanWeights and edgeCotanWeights all at once. Any of
+  // them which are not already computed are computed together in a single pass over the faces, rather than one pass
+  // each.
+  void requireTriangleQuantities();
+  void unrequireTriangleQuantities();
+
 
   // == Tangent vectors and transport
 
@@ -135,6 +144,14 @@ protected:
   DependentQuantityD<EdgeData<double>> edgeLengthsQ;
   virtual void computeEdgeLengths() = 0;
 
+  // Triangle quantities
+  // Note: like the DEC operators, these are several members grouped under one require. The group holds no data of its
+  // own; the placeholder buffer just lets purgeQuantities() reset it like any other quantity. The group comes before
+  // its members in the list of quantities, so refreshQuantities() computes them all in one pass.
+  int triangleQuantitiesPlaceholder = 0;
+  DependentQuantityD<int> triangleQuantitiesQ;
+  virtual void computeTriangleQuantities();
+
   // Face areas
   DependentQuantityD<FaceData<double>> faceAreasQ;
   virtual void computeFaceAreas();
@@ -209,6 +226,23 @@ protected:
   DependentQuantityD<Eigen::SparseMatrix<std::complex<double>>> vertexConnectionLaplacianQ;
   virtual void computeVertexConnectionLaplacian();
 
+  // Vertex adjacency sparsity pattern
+  // The cotan Laplacian, Galerkin mass matrix and connection Laplacian all share the sparsity pattern of the vertex
+  // adjacency. It is built once from the connectivity (in compressed column form) and cached, so recomputing these
+  // operators just rewrites the values of the existing matrices in one linear pass, without sorting or allocating.
+  // The pattern is checked against the connectivity each time it is used, and rebuilt if the mesh has changed.
+  struct VertexAdjacencyPattern {
+    std::vector<int> outerIndex;       // start of each column's entries
+    std::vector<int> innerIndex;       // row of each entry
+    std::vector<size_t> diagonalSlots; // entry (i,i), for each vertex index i
+    std::vector<size_t> halfedgeSlots; // entry (tip,tail), for each halfedge index
+  };
+  VertexAdjacencyPattern vertexAdjacencyPattern;
+  std::mutex vertexAdjacencyPatternMutex;
+  void ensureHaveVertexAdjacencyPattern();
+  template <typename T>
+  void initializeFromVertexAdjacencyPattern(Eigen::SparseMatrix<T>& matrix); // resizes and zeros the values
+
   // DEC Operators
   // Note: The DEC operators deviate from the convention of one member per quantity. This extra array allows the
   // DependentQuantityD<> helper type to still manage and clear out these members.
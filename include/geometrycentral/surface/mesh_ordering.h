@@ -0,0 +1,35 @@
+#pragma once
+
+#include "geometrycentral/surface/halfedge_mesh.h"
+#include "geometrycentral/surface/vertex_position_geometry.h"
+
+#include <vector>
+
+namespace geometrycentral {
+namespace surface {
+
+// Reorder mesh elements to improve memory locality. Meshes loaded from files often have an arbitrary element order,
+// which makes loops over the mesh and assembled matrices cache-unfriendly; these orderings place nearby elements at
+// nearby indices.
+
+// The available vertex orderings
+enum class MeshOrdering {
+  SpaceFillingCurve,  // sort vertices along a Morton (Z-order) curve through their positions
+  ReverseCuthillMcKee // breadth-first ordering of the vertex graph, which reduces the bandwidth of vertex matrices
+};
+
+// Vertex orderings, in the newToOld format expected by HalfedgeMesh::permuteVertices()
+std::vector<size_t> mortonVertexOrder(VertexPositionGeometry& geometry);
+std::vector<size_t> reverseCuthillMcKeeVertexOrder(HalfedgeMesh& mesh);
+
+// Permute the vertices of the mesh, then order the edges and faces to follow the vertices (each is sorted by its
+// lowest-index vertex, keeping the previous order for ties). All MeshData<> containers are permuted along with the
+// mesh. The mesh must be compressed.
+void applyVertexOrder(HalfedgeMesh& mesh, const std::vector<size_t>& vertexNewToOld);
+
+// Compute and apply an ordering to the geometry's mesh, then refresh any required quantities (cached quantities like
+// the Laplacian are indexed by element, so they are stale after reordering).
+void reorderForLocality(VertexPositionGeometry& geometry, MeshOrdering ordering = MeshOrdering::SpaceFillingCurve);
+
+} // namespace surface
+} // namespace geometrycentral
@@ -48,6 +48,7 @@ public:
 protected:
   // Override the compute vertex positions method for embedded geometry
   virtual void computeVertexPositions() override;
+  virtual void updateVertexPositions(const std::vector<Vertex>& changedVertices) override;
 
 
 private:
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace geometrycentral {
+
+// A cache of freed buffers, so that code which repeatedly allocates and frees buffers of the same sizes can reuse them
+// rather than going back to the heap. The typical case is a per-query algorithm, which builds a few VertexData<>
+// and FaceData<> containers on every call: with an arena alive around the query loop, only the first query allocates.
+//
+// An arena is active on the thread which created it, for as long as it is alive. Buffers allocated with an
+// ArenaAllocator<> (which all MeshData<> containers use) are taken from the active arena, and returned to it when freed.
+// Arenas nest; the innermost one is active. Buffers may safely outlive the arena they came from, or be freed on another
+// thread.
+//
+// The cache is capped at maxCachedBytes: buffers freed beyond that go straight back to the heap, so a long-lived arena
+// does not hold on to an unbounded amount of memory. clear() empties the cache at any time.
+class BufferArena {
+public:
+  static const size_t defaultMaxCachedBytes = size_t(1) << 28; // 256 MB
+
+  explicit BufferArena(size_t maxCachedBytes = defaultMaxCachedBytes);
+  ~BufferArena(); // releases all cached buffers, and makes the enclosing arena (if any) active again
+
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  // Get a buffer of exactly nBytes, reusing a cached one if possible
+  void* allocate(size_t nBytes);
+
+  // Return a buffer of nBytes to the cache
+  void deallocate(void* ptr, size_t nBytes);
+
+  // Release all cached buffers back to the heap
+  void clear();
+
+  // Total size of the buffers currently cached
+  size_t cachedBytes() const;
+
+  // Cap on the total size of cached buffers. Lowering it releases cached buffers until the cache fits.
+  size_t maxCachedBytes() const;
+  void setMaxCachedBytes(size_t newMax);
+
+  // The active arena on this thread, or nullptr if there is none
+  static BufferArena* active();
+
+private:
+  std::unordered_map<size_t, std::vector<void*>> freeBuffers; // keyed by size in bytes
+  size_t nCachedBytes = 0;
+  size_t nMaxCachedBytes;
+  BufferArena* enclosing;
+};
+
+// Allocator which draws from the active BufferArena on the current thread, or from the heap if there is none. Memory is
+// aligned like Eigen::aligned_allocator<>, so it is safe for fixed-size Eigen types.
+template <typename T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  ArenaAllocator() {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>&) {}
+
+  T* allocate(size_t n);
+  void deallocate(T* ptr, size_t n);
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return true;
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return false;
+}
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(size_t n) {
+  BufferArena* arena = BufferArena::active();
+  if (arena == nullptr) {
+    return Eigen::aligned_allocator<T>().allocate(n);
+  }
+  return static_cast<T*>(arena->allocate(n * sizeof(T)));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T* ptr, size_t n) {
+  BufferArena* arena = BufferArena::active();
+  if (arena == nullptr) {
+    Eigen::aligned_allocator<T>().deallocate(ptr, n);
+    return;
+  }
+  arena->deallocate(ptr, n * sizeof(T));
+}
+
+} // namespace geometrycentral
@@ -4,14 +4,23 @@
 // for an easy workaround are welcome.
 #include <Eigen/SparseCore>
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <vector>
-#include <array>
 
 
 namespace geometrycentral {
 
+// A quantity which is computed lazily, on demand.
+//
+// Requiring and reading quantities is safe from many threads at once: each quantity is computed at most once, and a
+// thread which requires a quantity while another is computing it blocks until the value is ready. (Computing quantities
+// constructs MeshData<> containers, so the underlying mesh should be frozen while multiple threads share it; see
+// HalfedgeMesh::freeze().) Refreshing, purging and thawing quantities are not thread-safe, and must not happen
+// concurrently with anything else.
 class DependentQuantity {
 
 public:
@@ -23,8 +32,8 @@ public:
   virtual ~DependentQuantity(){};
 
   std::function<void()> evaluateFunc;
-  bool computed = false;
-  int requireCount = 0;
+  std::atomic<bool> computed{false};
+  std::atomic<int> requireCount{0};
 
   // Compute the quantity, if we don't have it already
   void ensureHave();
@@ -32,6 +41,10 @@ public:
   // Compute the quantity if we need it and don't have it already
   void ensureHaveIfRequired();
 
+  // Like ensureHave(), but populate the quantity with the given function rather than the usual one. Used when one pass
+  // computes several quantities at once.
+  void ensureHaveWith(const std::function<void()>& populateFunc);
+
   // Note that something will reqiure this quantity (increments a count of such requirements),
   // and ensure that we have this quantity
   void require();
@@ -41,6 +54,14 @@ public:
 
   // Clear out the underlying quantity to reduce memory usage
   virtual void clearIfNotRequired() = 0;
+
+  // Register any containers in the underlying quantity which were created on a frozen mesh (see MeshData<>::thaw()),
+  // so that the quantity remains valid once the mesh is unfrozen
+  virtual void thaw() = 0;
+
+protected:
+  // Held while computing or clearing the quantity
+  std::mutex computeMutex;
 };
 
 // Wrapper class which manages a dependency graph of quantities. Templated on the underlying type of the data.
@@ -58,6 +79,9 @@ public:
 
   // Clear out the underlying quantity to reduce memory usage
   virtual void clearIfNotRequired() override;
+
+  // Register containers created on a frozen mesh
+  virtual void thaw() override;
 };
 
 } // namespace geometrycentral
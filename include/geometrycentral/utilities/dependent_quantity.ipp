@@ -9,27 +9,47 @@ inline void DependentQuantity::ensureHaveIfRequired() {
 inline void DependentQuantity::ensureHave() {
 
   // If the quantity is already populated, early out
-  if (computed) {
+  if (computed.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // Otherwise, compute it. If another thread got here first, this waits for it to finish, then finds the quantity
+  // already computed. Quantities only lock the quantities they depend on while computing, so this cannot deadlock.
+  std::lock_guard<std::mutex> lock(computeMutex);
+  if (computed.load(std::memory_order_relaxed)) {
     return;
   }
 
   // Compute this quantity
   evaluateFunc();
 
-  computed = true;
+  computed.store(true, std::memory_order_release);
 };
 
+inline void DependentQuantity::ensureHaveWith(const std::function<void()>& populateFunc) {
+  if (computed.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(computeMutex);
+  if (computed.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  populateFunc();
+
+  computed.store(true, std::memory_order_release);
+}
+
 inline void DependentQuantity::require() {
   requireCount++;
   ensureHave();
 }
 
 inline void DependentQuantity::unrequire() {
-  requireCount--;
-
-  if (requireCount < 0) {
+  if (requireCount-- <= 0) {
+    requireCount++;
     throw std::logic_error("Quantity was unrequire()'d more than than it was require()'d");
-    requireCount = 0;
   }
 }
 
@@ -66,14 +86,45 @@ void clearBuffer(std::array<A*, N>* buffer) {
   }
 }
 
+// Helper functions to thaw data, mirroring the above
+template <typename T>
+void thawBuffer(T* buffer) {
+  buffer->thaw();
+}
+
+// Scalars and Eigen types are not attached to the mesh
+inline void thawBuffer(double* buffer) {}
+inline void thawBuffer(size_t* buffer) {}
+inline void thawBuffer(int* buffer) {}
+
+template <typename F>
+void thawBuffer(Eigen::SparseMatrix<F>* buffer) {}
+
+template <typename A, size_t N>
+void thawBuffer(std::array<A*, N>* buffer) {
+  for (size_t i = 0; i < N; i++) {
+    A* elem = (*buffer)[i];
+    thawBuffer(elem);
+  }
+}
+
 } // namespace
 
 template <typename D>
 void DependentQuantityD<D>::clearIfNotRequired() {
+  std::lock_guard<std::mutex> lock(computeMutex);
   if (requireCount <= 0 && dataBuffer != nullptr && computed) {
     clearBuffer(dataBuffer);
     computed = false;
   }
 }
 
+template <typename D>
+void DependentQuantityD<D>::thaw() {
+  std::lock_guard<std::mutex> lock(computeMutex);
+  if (dataBuffer != nullptr && computed) {
+    thawBuffer(dataBuffer);
+  }
+}
+
 } // namespace geometrycentral
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// === Geometry kernels which evaluate many triangles at once with vector instructions
+
+namespace geometrycentral {
+
+// Instruction sets which the kernels can use, in increasing order of width
+enum class SIMDLevel { Scalar = 0, SSE2, AVX2, AVX512 };
+
+// The widest instruction set supported both by this build and by the CPU it is running on
+SIMDLevel bestSIMDLevel();
+
+// A batch of triangles, with the vertex positions in structure-of-arrays layout: positions[i][d] points to the d'th
+// coordinate of the i'th vertex of each triangle.
+struct TriangleBatch {
+  size_t size = 0;
+  std::array<std::array<const double*, 3>, 3> positions{};
+};
+
+// Where to write the results for a batch. Each output which is not null points to an array with an entry for each
+// triangle; outputs which are null are not computed.
+struct TriangleBatchOutputs {
+  double* areas = nullptr;
+  std::array<double*, 3> normals{};    // unit normal, by coordinate
+  std::array<double*, 3> angles{};     // interior angle at the i'th vertex
+  std::array<double*, 3> halfCotans{}; // half the cotangent of the angle opposite the edge from vertex i to i+1
+};
+
+// Evaluate the geometry of a batch of triangles, several triangles per instruction. The level is capped at
+// bestSIMDLevel(), so the default uses the widest instructions available.
+//
+// Each lane does exactly the arithmetic of the scalar version, so the results are bit-for-bit identical to the quantities
+// cached by the geometry interfaces (these and the kernels are built without FMA contraction for this reason). The
+// inline immediates (e.g. VertexPositionGeometry::faceArea()) are compiled with the caller's flags, so agree to within
+// rounding.
+void evaluateTriangleBatch(const TriangleBatch& batch, const TriangleBatchOutputs& outputs,
+                           SIMDLevel level = SIMDLevel::AVX512);
+
+} // namespace geometrycentral
@@ -6,6 +6,13 @@
 #include "geometrycentral/numerical/suitesparse_utilities.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <vector>
+
 using namespace Eigen;
 using std::cout;
 using std::endl;
@@ -18,8 +25,24 @@ struct PSDSolverInternals {
   CholmodContext context;
   cholmod_sparse* cMat = nullptr;
   cholmod_factor* factorization = nullptr;
+  CholeskyMode mode = CholeskyMode::Auto;
+
+  // Solution and workspaces for cholmod_l_solve2(), kept between solves so that repeated solves do not allocate.
+  // Cholmod owns these, and reallocates them if the number of right hand sides changes.
+  cholmod_dense* solveX = nullptr;
+  cholmod_dense* solveY = nullptr;
+  cholmod_dense* solveE = nullptr;
+
+  // Double precision copy of the right hand side, only used when T is float
+  std::vector<typename SOLVER_ENTRYTYPE<T>::type> rhsBuffer;
+
+  // Inverse of the fill-reducing permutation of the factorization, for update(). Built on first use, and cleared
+  // whenever the matrix is analyzed again.
+  std::vector<SuiteSparse_long> permInv;
 #else
   Eigen::SimplicialLDLT<SparseMatrix<T>> solver;
+
+  SparseMatrix<T> mat; // kept so that update() has something to add to
 #endif
 };
 
@@ -33,11 +56,323 @@ PositiveDefiniteSolver<T>::~PositiveDefiniteSolver() {
   if (internals->factorization != nullptr) {
     cholmod_l_free_factor(&internals->factorization, internals->context);
   }
+  if (internals->solveX != nullptr) {
+    cholmod_l_free_dense(&internals->solveX, internals->context);
+  }
+  if (internals->solveY != nullptr) {
+    cholmod_l_free_dense(&internals->solveY, internals->context);
+  }
+  if (internals->solveE != nullptr) {
+    cholmod_l_free_dense(&internals->solveE, internals->context);
+  }
 #endif
 }
 
+#ifdef GC_HAVE_SUITESPARSE
+namespace {
+// Solve for nCols right hand sides stored column-major in rhs, writing the solutions to sol. Cholmod reads the right
+// hand side in place, and solves into the solution and workspaces kept in internals, so repeated solves do not allocate
+// (except for float systems, which must go through a double precision copy of the right hand side). The solution is
+// copied out once at the end.
 template <typename T>
-PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
+void solveInPlace(PSDSolverInternals<T>& internals, const T* rhs, T* sol, size_t nRows, size_t nCols) {
+  typedef typename SOLVER_ENTRYTYPE<T>::type SCALAR_TYPE;
+
+  size_t nEntries = nRows * nCols;
+  if (nEntries == 0) {
+    return;
+  }
+
+  const SCALAR_TYPE* rhsS = reinterpret_cast<const SCALAR_TYPE*>(rhs);
+  if (!std::is_same<T, SCALAR_TYPE>::value) {
+    internals.rhsBuffer.resize(nEntries);
+    std::copy(rhs, rhs + nEntries, internals.rhsBuffer.begin());
+    rhsS = internals.rhsBuffer.data();
+  }
+
+  // Cholmod does not modify or free the right hand side, so it can be a view of our buffer. The solution, on the other
+  // hand, may be freed and reallocated by cholmod, so it must be one cholmod allocated.
+  cholmod_dense rhsView = cholmodDenseView(const_cast<SCALAR_TYPE*>(rhsS), nRows, nCols);
+  bool success = (bool)cholmod_l_solve2(CHOLMOD_A, internals.factorization, &rhsView, nullptr, &internals.solveX,
+                                        nullptr, &internals.solveY, &internals.solveE, internals.context);
+  if (!success || internals.solveX == nullptr) {
+    throw std::runtime_error("failure in cholmod_l_solve2");
+  }
+
+  const SCALAR_TYPE* solS = static_cast<const SCALAR_TYPE*>(internals.solveX->x);
+  size_t d = internals.solveX->d; // leading dimension
+  for (size_t iCol = 0; iCol < nCols; iCol++) {
+    for (size_t iRow = 0; iRow < nRows; iRow++) {
+      sol[iCol * nRows + iRow] = static_cast<T>(solS[iCol * d + iRow]);
+    }
+  }
+}
+
+// Configure the context for the requested factorization
+void setCholeskyOptions(CholmodContext& context, CholeskyMode mode, CholeskyOrdering ordering) {
+  switch (mode) {
+  case CholeskyMode::Auto:
+    // Supernodal factorizations are always LLt; if cholmod stays simplicial, it makes an LDLt
+    context.setAutoSupernodal();
+    context.setLDL();
+    break;
+  case CholeskyMode::SimplicialLDLT:
+    context.setSimplicial(); // must use simplicial for LDLt
+    context.setLDL();
+    break;
+  case CholeskyMode::SupernodalLLT:
+    context.setSupernodal();
+    context.setLL();
+    break;
+  }
+
+  switch (ordering) {
+  case CholeskyOrdering::Default:
+    context.setDefaultOrdering();
+    break;
+  case CholeskyOrdering::AMD:
+    context.setOrdering(CHOLMOD_AMD);
+    break;
+  case CholeskyOrdering::METIS:
+    context.setOrdering(CHOLMOD_METIS);
+    break;
+  case CholeskyOrdering::NestedDissection:
+    context.setOrdering(CHOLMOD_NESDIS);
+    break;
+  }
+}
+
+// Numerically factor internals.cMat, reusing the symbolic analysis in internals.factorization. Returns false if the
+// matrix turned out not to be positive definite.
+template <typename T>
+bool factorNumeric(PSDSolverInternals<T>& internals) {
+
+  // In auto mode, a supernodal factorization which fails is retried (see retryIfSemidefinite()), so cholmod should not
+  // print a warning about it
+  int printLevel = internals.context.context.print;
+  if (internals.mode == CholeskyMode::Auto && internals.factorization->is_super) {
+    internals.context.context.print = 1; // errors only
+  }
+  bool success = (bool)cholmod_l_factorize(internals.cMat, internals.factorization, internals.context);
+  internals.context.context.print = printLevel;
+  if (!success) {
+    throw std::runtime_error("failure in cholmod_l_factorize");
+  }
+
+  return internals.context.context.status != CHOLMOD_NOT_POSDEF;
+}
+
+// Analyze and factor internals.cMat. Returns false if the matrix turned out not to be positive definite.
+template <typename T>
+bool analyzeAndFactor(PSDSolverInternals<T>& internals) {
+  if (internals.factorization != nullptr) {
+    cholmod_l_free_factor(&internals.factorization, internals.context);
+  }
+  internals.permInv.clear();
+
+  internals.factorization = cholmod_l_analyze(internals.cMat, internals.context);
+  if (internals.factorization == nullptr) {
+    throw std::runtime_error("failure in cholmod_l_analyze (is the requested ordering available?)");
+  }
+
+  return factorNumeric(internals);
+}
+
+// A supernodal LLt fails on semi-definite matrices (like a Laplacian), which an LDLt handles. In auto mode, retry
+// with that. The fill-reducing ordering (the expensive part of the analysis) is kept, by turning the factorization
+// back into a simplicial symbolic one.
+template <typename T>
+bool retryIfSemidefinite(PSDSolverInternals<T>& internals) {
+  if (internals.mode == CholeskyMode::Auto && internals.factorization->is_super) {
+    internals.context.setSimplicial();
+    bool success = (bool)cholmod_l_change_factor(CHOLMOD_PATTERN, false, false, true, true, internals.factorization,
+                                                 internals.context);
+    if (!success) {
+      throw std::runtime_error("failure in cholmod_l_change_factor");
+    }
+    return factorNumeric(internals);
+  }
+  return false;
+}
+
+// Add delta to the stored matrix internals.cMat. When delta only touches stored entries (e.g. changed edge weights),
+// they are updated in place; otherwise the matrices are merged.
+template <typename T>
+void addToStoredMatrix(PSDSolverInternals<T>& internals, const SparseMatrix<T>& delta) {
+  typedef typename SOLVER_ENTRYTYPE<T>::type SCALAR_TYPE;
+
+  cholmod_sparse* A = internals.cMat;
+  SuiteSparse_long* colStart = (SuiteSparse_long*)A->p;
+  SuiteSparse_long* rowIndices = (SuiteSparse_long*)A->i;
+  SCALAR_TYPE* values = (SCALAR_TYPE*)A->x;
+
+  // Find the stored entry for each entry of delta
+  std::vector<SuiteSparse_long> slots;
+  slots.reserve(delta.nonZeros());
+  bool samePattern = true;
+  for (int iCol = 0; iCol < delta.outerSize() && samePattern; iCol++) {
+    SuiteSparse_long* colBegin = rowIndices + colStart[iCol];
+    SuiteSparse_long* colEnd = rowIndices + colStart[iCol + 1];
+    for (typename SparseMatrix<T>::InnerIterator it(delta, iCol); it; ++it) {
+      SuiteSparse_long* loc = std::lower_bound(colBegin, colEnd, (SuiteSparse_long)it.row());
+      if (loc == colEnd || *loc != it.row()) {
+        samePattern = false;
+        break;
+      }
+      slots.push_back(loc - rowIndices);
+    }
+  }
+
+  if (samePattern) {
+    size_t iSlot = 0;
+    for (int iCol = 0; iCol < delta.outerSize(); iCol++) {
+      for (typename SparseMatrix<T>::InnerIterator it(delta, iCol); it; ++it) {
+        values[slots[iSlot++]] += static_cast<SCALAR_TYPE>(it.value());
+      }
+    }
+    return;
+  }
+
+  // The stored matrix holds both triangles, so it can be summed as an unsymmetric one
+  SparseMatrix<T> deltaCopy = delta;
+  cholmod_sparse* cDelta = toCholmod(deltaCopy, internals.context);
+  int stype = A->stype;
+  A->stype = 0;
+  double one[2] = {1., 0.};
+  cholmod_sparse* sum = cholmod_l_add(A, cDelta, one, one, true, true, internals.context);
+  A->stype = stype;
+  cholmod_l_free_sparse(&cDelta, internals.context);
+  if (sum == nullptr) {
+    throw std::runtime_error("failure in cholmod_l_add");
+  }
+  sum->stype = stype;
+  cholmod_l_free_sparse(&internals.cMat, internals.context);
+  internals.cMat = sum;
+}
+
+// Apply a symmetric change delta to the factorization via rank-one updates and downdates. Returns false if this is not
+// possible (cholmod only modifies real factorizations).
+//
+// delta is written as a sum of signed rank-one terms: each off-diagonal pair delta_ij = delta_ji = d gives
+// -d (e_i - e_j)(e_i - e_j)^T plus d on the diagonal at i and j, and what remains on the diagonal gives multiples of
+// e_i e_i^T. For a change to the edge weights of a Laplacian the diagonal cancels, leaving one term per edge.
+template <typename T>
+bool updownFactor(PSDSolverInternals<T>& internals, const SparseMatrix<T>& delta) {
+
+  size_t N = delta.rows();
+  cholmod_factor* L = internals.factorization;
+
+  // The columns of the update must be given in the permuted order of the factorization. The permutation stays the
+  // same over updates, so its inverse is computed only once.
+  std::vector<SuiteSparse_long>& permInv = internals.permInv;
+  if (permInv.empty()) {
+    const SuiteSparse_long* perm = (const SuiteSparse_long*)L->Perm;
+    permInv.resize(N);
+    for (size_t i = 0; i < N; i++) {
+      permInv[perm[i]] = i;
+    }
+  }
+
+  // Gather the terms as (coefficient, i, j), with j = -1 for the diagonal ones
+  struct RankOneTerm {
+    double coef;
+    SuiteSparse_long i, j;
+  };
+  std::vector<RankOneTerm> terms;
+
+  // What remains on the diagonal of each touched row, along with the sizes of the contributions to it (to recognize
+  // cancellation)
+  struct DiagonalRemainder {
+    double value = 0.;
+    double scale = 0.;
+  };
+  std::map<SuiteSparse_long, DiagonalRemainder> diagonal;
+  auto addToDiagonal = [&](SuiteSparse_long i, double val) {
+    DiagonalRemainder& entry = diagonal[i];
+    entry.value += val;
+    entry.scale += std::abs(val);
+  };
+  for (int iCol = 0; iCol < delta.outerSize(); iCol++) {
+    for (typename SparseMatrix<T>::InnerIterator it(delta, iCol); it; ++it) {
+      SuiteSparse_long i = it.row();
+      SuiteSparse_long j = it.col();
+      double d = static_cast<double>(it.value());
+      if (d == 0. || i > j) continue; // the lower triangle mirrors the upper
+      if (i == j) {
+        addToDiagonal(i, d);
+      } else {
+        terms.push_back(RankOneTerm{-d, i, j});
+        addToDiagonal(i, d);
+        addToDiagonal(j, d);
+      }
+    }
+  }
+  for (const std::pair<const SuiteSparse_long, DiagonalRemainder>& entry : diagonal) {
+    const DiagonalRemainder& r = entry.second;
+    if (std::abs(r.value) > 16 * std::numeric_limits<double>::epsilon() * r.scale) {
+      terms.push_back(RankOneTerm{r.value, entry.first, -1});
+    }
+  }
+
+  // Apply the positive terms as an update, then the negative ones as a downdate
+  for (bool isUpdate : {true, false}) {
+
+    size_t nTerms = 0;
+    size_t nEntries = 0;
+    for (const RankOneTerm& t : terms) {
+      if ((t.coef > 0) == isUpdate) {
+        nTerms++;
+        nEntries += (t.j == -1) ? 1 : 2;
+      }
+    }
+    if (nTerms == 0) continue;
+
+    cholmod_sparse* C = cholmod_l_allocate_sparse(N, nTerms, nEntries, true, true, 0, CHOLMOD_REAL, internals.context);
+    double* values = (double*)C->x;
+    SuiteSparse_long* rowIndices = (SuiteSparse_long*)C->i;
+    SuiteSparse_long* colStart = (SuiteSparse_long*)C->p;
+
+    size_t iCol = 0;
+    size_t iEntry = 0;
+    for (const RankOneTerm& t : terms) {
+      if ((t.coef > 0) != isUpdate) continue;
+      colStart[iCol++] = iEntry;
+      double s = std::sqrt(std::abs(t.coef));
+      if (t.j == -1) {
+        rowIndices[iEntry] = permInv[t.i];
+        values[iEntry++] = s;
+      } else {
+        SuiteSparse_long pi = permInv[t.i];
+        SuiteSparse_long pj = permInv[t.j];
+        rowIndices[iEntry] = std::min(pi, pj);
+        values[iEntry++] = (pi < pj) ? s : -s;
+        rowIndices[iEntry] = std::max(pi, pj);
+        values[iEntry++] = (pi < pj) ? -s : s;
+      }
+    }
+    colStart[nTerms] = nEntries;
+
+    bool success = (bool)cholmod_l_updown(isUpdate, C, L, internals.context);
+    cholmod_l_free_sparse(&C, internals.context);
+    if (!success) {
+      throw std::runtime_error("failure in cholmod_l_updown");
+    }
+    if (internals.context.context.status == CHOLMOD_NOT_POSDEF) {
+      throw std::runtime_error("matrix is not positive definite");
+    }
+  }
+
+  return true;
+}
+template <>
+bool updownFactor(PSDSolverInternals<std::complex<double>>& internals, const SparseMatrix<std::complex<double>>& delta) {
+  return false;
+}
+} // namespace
+#endif
+
+template <typename T>
+PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat, CholeskyMode mode, CholeskyOrdering ordering)
     : LinearSolver<T>(mat), internals(new PSDSolverInternals<T>()) {
 
 
@@ -63,22 +398,17 @@ PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
   internals->cMat = toCholmod(mat, internals->context, SType::SYMMETRIC);
 
   // Factor
-  internals->context.setSimplicial(); // must use simplicial for LDLt
-  internals->context.setLDL();        // ensure we get an LDLt internals->factorization
-  internals->factorization = cholmod_l_analyze(internals->cMat, internals->context);
-  bool success = (bool)cholmod_l_factorize(internals->cMat, internals->factorization, internals->context);
-
-  if(!success) {
-    throw std::runtime_error("failure in cholmod_l_factorize");
-  }
-  if(internals->context.context.status == CHOLMOD_NOT_POSDEF) {
+  internals->mode = mode;
+  setCholeskyOptions(internals->context, mode, ordering);
+  bool posDef = analyzeAndFactor(*internals) || retryIfSemidefinite(*internals);
+  if (!posDef) {
     throw std::runtime_error("matrix is not positive definite");
   }
 
-  
 
   // Eigen version
 #else
+  internals->mat = mat;
   internals->solver.compute(mat);
   if (internals->solver.info() != Eigen::Success) {
     std::cerr << "Solver internals->factorization error: " << internals->solver.info() << std::endl;
@@ -87,6 +417,81 @@ PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
 #endif
 };
 
+template <typename T>
+void PositiveDefiniteSolver<T>::refactor(const SparseMatrix<T>& mat) {
+
+  // Check some sanity
+  if ((size_t)mat.rows() != this->nRows || (size_t)mat.cols() != this->nCols) {
+    throw std::logic_error("Matrix is not the same size as the original");
+  }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(mat);
+  checkHermitian(mat);
+#endif
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Update the values in place, then redo only the numeric factorization
+  if (!copyValuesToCholmod(mat, internals->cMat)) {
+    throw std::logic_error("Matrix does not have the same sparsity pattern as the original");
+  }
+
+  bool posDef = factorNumeric(*internals) || retryIfSemidefinite(*internals);
+  if (!posDef) {
+    throw std::runtime_error("matrix is not positive definite");
+  }
+
+  // Eigen version
+#else
+  internals->mat = mat;
+  internals->solver.factorize(mat);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver internals->factorization error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solver internals->factorization failed");
+  }
+#endif
+}
+
+template <typename T>
+void PositiveDefiniteSolver<T>::update(const SparseMatrix<T>& delta) {
+
+  // Check some sanity
+  if ((size_t)delta.rows() != this->nRows || (size_t)delta.cols() != this->nCols) {
+    throw std::logic_error("Matrix is not the same size as the original");
+  }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(delta);
+  checkHermitian(delta);
+#endif
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Keep the stored matrix current, so later refactor() calls see the updated pattern
+  addToStoredMatrix(*internals, delta);
+
+  // Complex factorizations cannot be modified in place, and are factored again (with a new analysis, since the
+  // pattern may have changed)
+  if (!updownFactor(*internals, delta)) {
+    bool posDef = analyzeAndFactor(*internals) || retryIfSemidefinite(*internals);
+    if (!posDef) {
+      throw std::runtime_error("matrix is not positive definite");
+    }
+  }
+
+  // Eigen version
+#else
+  // Eigen's factorization cannot be modified, so factor A + delta from scratch
+  internals->mat += delta;
+  internals->solver.compute(internals->mat);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver internals->factorization error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solver internals->factorization failed");
+  }
+#endif
+}
+
 template <typename T>
 Vector<T> PositiveDefiniteSolver<T>::solve(const Vector<T>& rhs) {
   Vector<T> out;
@@ -111,23 +516,47 @@ void PositiveDefiniteSolver<T>::solve(Vector<T>& x, const Vector<T>& rhs) {
   // Suitesparse version
 #ifdef GC_HAVE_SUITESPARSE
 
-  // Convert input to suitesparse format
-  cholmod_dense* inVec = toCholmod(rhs, internals->context);
+  // Solve directly from and to the Eigen buffers
+  x.resize(N);
+  solveInPlace(*internals, rhs.data(), x.data(), N, 1);
 
+  // Eigen version
+#else
   // Solve
-  cholmod_dense* outVec = cholmod_l_solve(CHOLMOD_A, internals->factorization, inVec, internals->context);
+  x = internals->solver.solve(rhs);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solve failed");
+  }
+#endif
+}
 
-  // Convert back
-  toEigen(outVec, internals->context, x);
+template <typename T>
+void PositiveDefiniteSolver<T>::solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) {
 
-  // Free
-  cholmod_l_free_dense(&outVec, internals->context);
-  cholmod_l_free_dense(&inVec, internals->context);
+  size_t N = this->nRows;
+
+  // Check some sanity
+  if ((size_t)B.rows() != N) {
+    throw std::logic_error("Matrix is not the right height");
+  }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(B);
+#endif
+
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Solve for all columns at once (for supernodal factorizations, this uses BLAS-3 triangular solves), directly from
+  // and to the Eigen buffers
+  X.resize(N, B.cols());
+  solveInPlace(*internals, B.data(), X.data(), N, B.cols());
 
   // Eigen version
 #else
   // Solve
-  x = internals->solver.solve(rhs);
+  X = internals->solver.solve(B);
   if (internals->solver.info() != Eigen::Success) {
     std::cerr << "Solver error: " << internals->solver.info() << std::endl;
     throw std::invalid_argument("Solve failed");
@@ -44,6 +44,41 @@ Solver<T>::~Solver() {
 #endif
 }
 
+#ifdef GC_HAVE_SUITESPARSE
+namespace {
+// Factor from scratch, symbolic analysis and all. Factors A^T rather than A for underdetermined systems.
+template <typename T>
+void spqrFactorize(QRSolverInternals<T>& internals, bool underdetermined) {
+
+  //  ordering options:
+  //       0 or 3: fixed
+  //       1: natural (only look for singletons)
+  //       2: colamd after finding singletons
+  //       4: CHOLMOD fter finding singletons
+  //       5: amd(A'*A) after finding singletons
+  //       6: metis(A'*A) after finding singletons
+  //       7: SuiteSparseQR default (selects COLAMD, AMD, or METIS)
+  const int ordering = 7;
+
+  if (internals.factorization != nullptr) {
+    SuiteSparseQR_free(&(internals.factorization), internals.context);
+  }
+
+  if (underdetermined) {
+    internals.factorization = SuiteSparseQR_factorize<typename SOLVER_ENTRYTYPE<T>::type>(
+        ordering, internals.zero_tolerance, internals.cMatTrans, internals.context);
+  } else {
+    internals.factorization = SuiteSparseQR_factorize<typename SOLVER_ENTRYTYPE<T>::type>(
+        ordering, internals.zero_tolerance, internals.cMat, internals.context);
+  }
+
+  if (internals.factorization == nullptr) {
+    throw std::logic_error("Factorization failed");
+  }
+}
+} // namespace
+#endif
+
 template <typename T>
 Solver<T>::Solver(SparseMatrix<T>& mat) : LinearSolver<T>(mat), internals(new QRSolverInternals<T>()) {
 
@@ -84,47 +119,115 @@ Solver<T>::Solver(SparseMatrix<T>& mat) : LinearSolver<T>(mat), internals(new QR
   }
 
   // Factor
+  spqrFactorize(*internals, underdetermined);
 
-  //  ordering options:
-  //       0 or 3: fixed
-  //       1: natural (only look for singletons)
-  //       2: colamd after finding singletons
-  //       4: CHOLMOD fter finding singletons
-  //       5: amd(A'*A) after finding singletons
-  //       6: metis(A'*A) after finding singletons
-  //       7: SuiteSparseQR default (selects COLAMD, AMD, or METIS)
-  const int ordering = 7;
+// Eigen version
+#else
+  if (underdetermined) {
+    throw std::logic_error("Eigen's sparse QR solver doesn't like underdetermined systems");
+  }
 
-  if (internals->factorization != nullptr) {
-    SuiteSparseQR_free(&(internals->factorization), internals->context);
+  internals->solver.setPivotThreshold(0.);
+  internals->solver.compute(mat);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver factorization error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solver factorization failed");
   }
+#endif
+};
+
+#ifdef GC_HAVE_SUITESPARSE
+namespace {
+// Apply a QR factorization to each column of rhs. Caller is responsible for freeing the result.
+// Note that the solve strategy is different for underdetermined systems
+template <typename T>
+cholmod_dense* spqrSolve(QRSolverInternals<T>& internals, bool underdetermined, cholmod_dense* rhs) {
+  cholmod_dense* out;
 
   if (underdetermined) {
-    internals->factorization = SuiteSparseQR_factorize<typename SOLVER_ENTRYTYPE<T>::type>(
-        ordering, internals->zero_tolerance, internals->cMatTrans, internals->context);
+
+    // solve y = R^-T b
+    cholmod_dense* y = SuiteSparseQR_solve<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_RTX_EQUALS_B,
+                                                                               internals.factorization, rhs,
+                                                                               internals.context);
+
+    // compute x = Q*y
+    out = SuiteSparseQR_qmult<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_QX, internals.factorization, y,
+                                                                  internals.context);
+    cholmod_l_free_dense(&y, internals.context);
+
   } else {
-    internals->factorization = SuiteSparseQR_factorize<typename SOLVER_ENTRYTYPE<T>::type>(
-        ordering, internals->zero_tolerance, internals->cMat, internals->context);
+
+    // compute y = Q^T b
+    cholmod_dense* y = SuiteSparseQR_qmult<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_QTX, internals.factorization,
+                                                                               rhs, internals.context);
+
+    // solve x = R^-1 y
+    // TODO what is this E doing here?
+    out = SuiteSparseQR_solve<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_RETX_EQUALS_B, internals.factorization, y,
+                                                                  internals.context);
+
+    cholmod_l_free_dense(&y, internals.context);
   }
 
-  if (internals->factorization == nullptr) {
-    throw std::logic_error("Factorization failed");
+  return out;
+}
+} // namespace
+#endif
+
+template <typename T>
+void Solver<T>::refactor(const SparseMatrix<T>& mat) {
+
+  // Check some sanity
+  if ((size_t)mat.rows() != this->nRows || (size_t)mat.cols() != this->nCols) {
+    throw std::logic_error("Matrix is not the same size as the original");
   }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(mat);
+#endif
 
-// Eigen version
-#else
+// Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Update the values of whichever matrix was factored in place (for underdetermined systems, the conjugate
+  // transpose, matching cholmod_l_transpose() in the constructor)
+  bool samePattern;
+  cholmod_sparse* factored;
   if (underdetermined) {
-    throw std::logic_error("Eigen's sparse QR solver doesn't like underdetermined systems");
+    SparseMatrix<T> matAdjoint = mat.adjoint();
+    samePattern = copyValuesToCholmod(matAdjoint, internals->cMatTrans);
+    factored = internals->cMatTrans;
+  } else {
+    samePattern = copyValuesToCholmod(mat, internals->cMat);
+    factored = internals->cMat;
+  }
+  if (!samePattern) {
+    throw std::logic_error("Matrix does not have the same sparsity pattern as the original");
   }
 
-  internals->solver.setPivotThreshold(0.);
-  internals->solver.compute(mat);
+  // Redo only the numeric factorization. SPQR refuses to do this for factorizations which split off singleton columns
+  // or which were computed together with a right hand side (it reports an error), and it needs the symbolic analysis,
+  // so factor from scratch when any of these do not hold.
+  const auto* factorization = internals->factorization;
+  if (factorization->n1cols > 0 || factorization->bncols > 0 || factorization->QRsym == nullptr) {
+    spqrFactorize(*internals, underdetermined);
+  } else {
+    bool success = (bool)SuiteSparseQR_numeric<typename SOLVER_ENTRYTYPE<T>::type>(
+        internals->zero_tolerance, factored, internals->factorization, internals->context);
+    if (!success) {
+      throw std::runtime_error("failure in SuiteSparseQR_numeric");
+    }
+  }
+
+// Eigen version
+#else
+  internals->solver.factorize(mat);
   if (internals->solver.info() != Eigen::Success) {
     std::cerr << "Solver factorization error: " << internals->solver.info() << std::endl;
     throw std::invalid_argument("Solver factorization failed");
   }
 #endif
-};
+}
 
 template <typename T>
 Vector<T> Solver<T>::solve(const Vector<T>& rhs) {
@@ -149,50 +252,60 @@ void Solver<T>::solve(Vector<T>& x, const Vector<T>& rhs) {
 
   // Convert input to suitesparse format
   cholmod_dense* inVec = toCholmod(rhs, internals->context);
-  cholmod_dense* outVec;
 
   // Solve
-  // outVec = SuiteSparseQR<typename Solver<T>::SOLVER_ENTRYTYPE>(cMat, inVec, internals->context);
-  // Note that the solve strategy is different for underdetermined systems
-  if (underdetermined) {
-
-    // solve y = R^-T b
-    cholmod_dense* y = SuiteSparseQR_solve<typename SOLVER_ENTRYTYPE<T>::type>(
-        SPQR_RTX_EQUALS_B, internals->factorization, inVec, internals->context);
+  cholmod_dense* outVec = spqrSolve(*internals, underdetermined, inVec);
 
-    // compute x = Q*y
-    outVec = SuiteSparseQR_qmult<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_QX, internals->factorization, y,
-                                                                     internals->context);
-    cholmod_l_free_dense(&y, internals->context);
+  // Convert back
+  toEigen(outVec, internals->context, x);
 
-  } else {
+  // Free
+  cholmod_l_free_dense(&outVec, internals->context);
+  cholmod_l_free_dense(&inVec, internals->context);
 
-    // compute y = Q^T b
-    cholmod_dense* y = SuiteSparseQR_qmult<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_QTX, internals->factorization,
-                                                                               inVec, internals->context);
+// Eigen version
+#else
+  // Solve
+  x = internals->solver.solve(rhs);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver error: " << internals->solver.info() << std::endl;
+    // std::cerr << "Solver says: " << solver.lastErrorMessage() << std::endl;
+    throw std::invalid_argument("Solve failed");
+  }
+#endif
+}
 
-    // solve x = R^-1 y
-    // TODO what is this E doing here?
-    outVec = SuiteSparseQR_solve<typename SOLVER_ENTRYTYPE<T>::type>(SPQR_RETX_EQUALS_B, internals->factorization, y,
-                                                                     internals->context);
+template <typename T>
+void Solver<T>::solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) {
 
-    cholmod_l_free_dense(&y, internals->context);
+  // Check some sanity
+  if ((size_t)B.rows() != this->nRows) {
+    throw std::logic_error("Matrix is not the right height");
   }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(B);
+#endif
+
+// Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Convert input to suitesparse format, and solve for all columns at once
+  cholmod_dense* inMat = toCholmod(B, internals->context);
+  cholmod_dense* outMat = spqrSolve(*internals, underdetermined, inMat);
 
   // Convert back
-  toEigen(outVec, internals->context, x);
+  toEigen(outMat, internals->context, X);
 
   // Free
-  cholmod_l_free_dense(&outVec, internals->context);
-  cholmod_l_free_dense(&inVec, internals->context);
+  cholmod_l_free_dense(&outMat, internals->context);
+  cholmod_l_free_dense(&inMat, internals->context);
 
 // Eigen version
 #else
   // Solve
-  x = internals->solver.solve(rhs);
+  X = internals->solver.solve(B);
   if (internals->solver.info() != Eigen::Success) {
     std::cerr << "Solver error: " << internals->solver.info() << std::endl;
-    // std::cerr << "Solver says: " << solver.lastErrorMessage() << std::endl;
     throw std::invalid_argument("Solve failed");
   }
 #endif
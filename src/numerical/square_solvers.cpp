@@ -76,6 +76,35 @@ void umfFactor<std::complex<double>>(size_t N, cholmod_sparse* mat, void*& symbo
   umfpack_zl_numeric(cMat_p, cMat_i, cMat_x, NULL, symbolicFac, &numericFac, NULL, NULL);
 }
 
+// = Numeric refactorization, reusing the symbolic factorization
+template <typename T>
+void umfRefactor(cholmod_sparse* mat, void* symbolicFac, void*& numericFac);
+
+template <>
+void umfRefactor<double>(cholmod_sparse* mat, void* symbolicFac, void*& numericFac) {
+  SuiteSparse_long* cMat_p = (SuiteSparse_long*)mat->p;
+  SuiteSparse_long* cMat_i = (SuiteSparse_long*)mat->i;
+  double* cMat_x = (double*)mat->x;
+  umfpack_dl_free_numeric(&numericFac);
+  umfpack_dl_numeric(cMat_p, cMat_i, cMat_x, symbolicFac, &numericFac, NULL, NULL);
+}
+template <>
+void umfRefactor<float>(cholmod_sparse* mat, void* symbolicFac, void*& numericFac) {
+  SuiteSparse_long* cMat_p = (SuiteSparse_long*)mat->p;
+  SuiteSparse_long* cMat_i = (SuiteSparse_long*)mat->i;
+  double* cMat_x = (double*)mat->x;
+  umfpack_dl_free_numeric(&numericFac);
+  umfpack_dl_numeric(cMat_p, cMat_i, cMat_x, symbolicFac, &numericFac, NULL, NULL);
+}
+template <>
+void umfRefactor<std::complex<double>>(cholmod_sparse* mat, void* symbolicFac, void*& numericFac) {
+  SuiteSparse_long* cMat_p = (SuiteSparse_long*)mat->p;
+  SuiteSparse_long* cMat_i = (SuiteSparse_long*)mat->i;
+  double* cMat_x = (double*)mat->x;
+  umfpack_zl_free_numeric(&numericFac);
+  umfpack_zl_numeric(cMat_p, cMat_i, cMat_x, NULL, symbolicFac, &numericFac, NULL, NULL);
+}
+
 // = Solves
 template <typename T>
 void umfSolve(size_t N, cholmod_sparse* mat, void* numericFac, Vector<T>& x, const Vector<T>& rhs);
@@ -150,6 +179,35 @@ SquareSolver<T>::SquareSolver(SparseMatrix<T>& mat) : LinearSolver<T>(mat), inte
 #endif
 };
 
+template <typename T>
+void SquareSolver<T>::refactor(const SparseMatrix<T>& mat) {
+
+  // Check some sanity
+  if ((size_t)mat.rows() != this->nRows || (size_t)mat.cols() != this->nCols) {
+    throw std::logic_error("Matrix is not the same size as the original");
+  }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(mat);
+#endif
+
+// Suitesparse variant
+#ifdef GC_HAVE_SUITESPARSE
+  // Update the values in place, then redo only the numeric factorization
+  if (!copyValuesToCholmod(mat, internals->cMat)) {
+    throw std::logic_error("Matrix does not have the same sparsity pattern as the original");
+  }
+  umfRefactor<T>(internals->cMat, internals->symbolicFactorization, internals->numericFactorization);
+
+// Eigen variant
+#else
+  internals->solver.factorize(mat);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver factorization error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solver factorization failed");
+  }
+#endif
+}
+
 template <typename T>
 Vector<T> SquareSolver<T>::solve(const Vector<T>& rhs) {
   Vector<T> out;
@@ -188,6 +246,44 @@ void SquareSolver<T>::solve(Vector<T>& x, const Vector<T>& rhs) {
 #endif
 }
 
+template <typename T>
+void SquareSolver<T>::solve(DenseMatrix<T>& X, const DenseMatrix<T>& B) {
+
+  size_t N = this->nRows;
+
+  // Check some sanity
+#ifndef GC_NLINALG_DEBUG
+  if ((size_t)B.rows() != N) {
+    throw std::logic_error("Matrix is not the right height");
+  }
+  checkFinite(B);
+#endif
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // UMFPACK has no blocked solve, so solve for each column in turn against the same factorization
+  X.resize(N, B.cols());
+  Vector<T> xCol;
+  Vector<T> rhsCol;
+  for (Eigen::Index j = 0; j < B.cols(); j++) {
+    rhsCol = B.col(j);
+    umfSolve<T>(N, internals->cMat, internals->numericFactorization, xCol, rhsCol);
+    X.col(j) = xCol;
+  }
+
+  // Eigen version
+#else
+  // Solve
+  X = internals->solver.solve(B);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver error: " << internals->solver.info() << std::endl;
+    std::cerr << "Solver says: " << internals->solver.lastErrorMessage() << std::endl;
+    throw std::invalid_argument("Solve failed");
+  }
+#endif
+}
+
 template <typename T>
 Vector<T> solveSquare(SparseMatrix<T>& A, const Vector<T>& rhs) {
   SquareSolver<T> s(A);
@@ -20,6 +20,20 @@ void CholmodContext::setSimplicial(void) { context.supernodal = CHOLMOD_SIMPLICI
 
 void CholmodContext::setSupernodal(void) { context.supernodal = CHOLMOD_SUPERNODAL; }
 
+void CholmodContext::setAutoSupernodal(void) { context.supernodal = CHOLMOD_AUTO; }
+
+void CholmodContext::setOrdering(int method) {
+  context.nmethods = 1;
+  context.method[0].ordering = method;
+  context.postorder = true;
+}
+
+void CholmodContext::setDefaultOrdering(void) {
+  context.nmethods = 0;
+  context.method[0].ordering = CHOLMOD_GIVEN; // as set by cholmod_l_start()
+  context.postorder = true;
+}
+
 void CholmodContext::setLL(void) { context.final_ll = true; }
 
 void CholmodContext::setLDL(void) { context.final_ll = false; }
@@ -45,6 +59,16 @@ int flagForStype(SType s) {
   }
   return -1;
 }
+
+// Helper to pick the cholmod xtype for an entry type
+template <typename T>
+struct CholmodXType {
+  static const int value = CHOLMOD_REAL;
+};
+template <>
+struct CholmodXType<std::complex<double>> {
+  static const int value = CHOLMOD_COMPLEX;
+};
 } // namespace
 
 // double-valued sparse matrices
@@ -144,6 +168,54 @@ cholmod_sparse* toCholmod(SparseMatrix<std::complex<double>>& A, CholmodContext&
   return cMat;
 }
 
+// Overwrite values of a sparse matrix
+template <typename T>
+bool copyValuesToCholmod(const Eigen::SparseMatrix<T, Eigen::ColMajor>& A, cholmod_sparse* cMat) {
+
+  if (!A.isCompressed()) {
+    Eigen::SparseMatrix<T, Eigen::ColMajor> compressedA = A;
+    compressedA.makeCompressed();
+    return copyValuesToCholmod(compressedA, cMat);
+  }
+
+  size_t Nentries = A.nonZeros();
+  size_t Ncols = A.cols();
+  size_t Nrows = A.rows();
+
+  // Check that the pattern matches
+  if (Nrows != cMat->nrow || Ncols != cMat->ncol) {
+    return false;
+  }
+  SuiteSparse_long* rowIndices = (SuiteSparse_long*)cMat->i;
+  SuiteSparse_long* colStart = (SuiteSparse_long*)cMat->p;
+  if (static_cast<size_t>(colStart[Ncols]) != Nentries) {
+    return false;
+  }
+  for (size_t iCol = 0; iCol < Ncols; iCol++) {
+    if (colStart[iCol] != A.outerIndexPtr()[iCol]) {
+      return false;
+    }
+  }
+  for (size_t iEntry = 0; iEntry < Nentries; iEntry++) {
+    if (rowIndices[iEntry] != A.innerIndexPtr()[iEntry]) {
+      return false;
+    }
+  }
+
+  // Copy
+  typedef typename SOLVER_ENTRYTYPE<T>::type SCALAR_TYPE;
+  SCALAR_TYPE* values = (SCALAR_TYPE*)cMat->x;
+  for (size_t iEntry = 0; iEntry < Nentries; iEntry++) {
+    values[iEntry] = A.valuePtr()[iEntry];
+  }
+
+  return true;
+}
+template bool copyValuesToCholmod(const Eigen::SparseMatrix<double, Eigen::ColMajor>& A, cholmod_sparse* cMat);
+template bool copyValuesToCholmod(const Eigen::SparseMatrix<float, Eigen::ColMajor>& A, cholmod_sparse* cMat);
+template bool copyValuesToCholmod(const Eigen::SparseMatrix<std::complex<double>, Eigen::ColMajor>& A,
+                                  cholmod_sparse* cMat);
+
 // Double-valued vector
 template <>
 cholmod_dense* toCholmod(const Eigen::Matrix<double, Eigen::Dynamic, 1>& v, CholmodContext& context) {
@@ -214,5 +286,86 @@ template void toEigen(cholmod_dense* cVec, CholmodContext& context, Eigen::Matri
 template void toEigen(cholmod_dense* cVec, CholmodContext& context,
                       Eigen::Matrix<std::complex<double>, Eigen::Dynamic, 1>& xOut);
 
+// Convert a dense matrix
+template <typename T>
+cholmod_dense* toCholmod(const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& M, CholmodContext& context) {
+
+  size_t nRows = M.rows();
+  size_t nCols = M.cols();
+
+  cholmod_dense* cMat = cholmod_l_allocate_dense(nRows, nCols, nRows, CholmodXType<T>::value, context);
+
+  // Cholmod always uses double precision
+  typedef typename SOLVER_ENTRYTYPE<T>::type SCALAR_TYPE;
+
+  // Both are column-major
+  SCALAR_TYPE* cMatS = (SCALAR_TYPE*)cMat->x;
+  for (size_t j = 0; j < nCols; j++) {
+    for (size_t i = 0; i < nRows; i++) {
+      cMatS[i + j * nRows] = M(i, j);
+    }
+  }
+
+  return cMat;
+}
+template cholmod_dense* toCholmod(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& M,
+                                  CholmodContext& context);
+template cholmod_dense* toCholmod(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& M,
+                                  CholmodContext& context);
+template cholmod_dense* toCholmod(const Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic>& M,
+                                  CholmodContext& context);
+
+// Convert a dense matrix
+template <typename T>
+void toEigen(cholmod_dense* cMat, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& xOut) {
+
+  size_t nRows = cMat->nrow;
+  size_t nCols = cMat->ncol;
+  size_t stride = cMat->d;
+
+  // Ensure output is large enough
+  xOut.resize(nRows, nCols);
+
+  typedef typename SOLVER_ENTRYTYPE<T>::type SCALAR_TYPE;
+
+  SCALAR_TYPE* cMatS = (SCALAR_TYPE*)cMat->x;
+  for (size_t j = 0; j < nCols; j++) {
+    for (size_t i = 0; i < nRows; i++) {
+      xOut(i, j) = cMatS[i + j * stride];
+    }
+  }
+}
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+
+// === Views
+
+namespace {
+cholmod_dense makeDenseView(void* data, size_t nRows, size_t nCols, int xtype) {
+  cholmod_dense view;
+  view.nrow = nRows;
+  view.ncol = nCols;
+  view.nzmax = nRows * nCols;
+  view.d = nRows;
+  view.x = data;
+  view.z = nullptr;
+  view.xtype = xtype;
+  view.dtype = CHOLMOD_DOUBLE;
+  return view;
+}
+} // namespace
+
+cholmod_dense cholmodDenseView(double* data, size_t nRows, size_t nCols) {
+  return makeDenseView(static_cast<void*>(data), nRows, nCols, CHOLMOD_REAL);
+}
+
+cholmod_dense cholmodDenseView(std::complex<double>* data, size_t nRows, size_t nCols) {
+  return makeDenseView(static_cast<void*>(data), nRows, nCols, CHOLMOD_COMPLEX);
+}
+
 } // namespace geometrycentral
 #endif
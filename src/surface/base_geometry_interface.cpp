@@ -1,5 +1,10 @@
 #include "geometrycentral/surface/base_geometry_interface.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -39,6 +44,62 @@ void BaseGeometryInterface::purgeQuantities() {
   }
 }
 
+void BaseGeometryInterface::thawQuantities() {
+  for (DependentQuantity* q : quantities) {
+    q->thaw();
+  }
+}
+
+namespace {
+// Makes containers on the mesh lock its callback mutex for as long as it is alive
+struct SharedCallbackScope {
+  SharedCallbackScope(HalfedgeMesh& mesh_) : mesh(mesh_) { mesh.sharedCallbackCount++; }
+  ~SharedCallbackScope() { mesh.sharedCallbackCount--; }
+  HalfedgeMesh& mesh;
+};
+} // namespace
+
+void BaseGeometryInterface::requireAll(const std::vector<std::function<void()>>& requireFuncs, size_t nThreads) {
+  if (nThreads == 0) {
+    nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  nThreads = std::min(nThreads, requireFuncs.size());
+  if (nThreads <= 1) {
+    for (const std::function<void()>& f : requireFuncs) f();
+    return;
+  }
+
+  // Computing quantities creates containers, which must take turns registering with the mesh. The count (rather than a
+  // flag) keeps this correct when calls are nested, or made from several threads.
+  SharedCallbackScope callbackScope(mesh);
+
+  // Each thread takes the next requested quantity until there are none left. Dependencies are shared via the locks in
+  // DependentQuantity::ensureHave(), so there is no need to order the requests.
+  std::atomic<size_t> iNext(0);
+  std::vector<std::exception_ptr> errors(requireFuncs.size());
+  auto worker = [&]() {
+    for (size_t i = iNext++; i < requireFuncs.size(); i = iNext++) {
+      try {
+        requireFuncs[i]();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t iThread = 1; iThread < nThreads; iThread++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  for (std::exception_ptr& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
 // == Indices
 
 // Vertex indices
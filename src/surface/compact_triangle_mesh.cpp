@@ -0,0 +1,368 @@
+#include "geometrycentral/surface/compact_triangle_mesh.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace geometrycentral {
+namespace surface {
+
+CompactTriangleMesh::CompactTriangleMesh(const std::vector<std::array<size_t, 3>>& triangles) {
+
+  // Copy the vertices in to the halfedge slots, and find the number of vertices
+  size_t nV = 0;
+  heVertexArr.resize(3 * triangles.size());
+  for (size_t iF = 0; iF < triangles.size(); iF++) {
+    for (size_t k = 0; k < 3; k++) {
+      size_t iV = triangles[iF][k];
+      GC_SAFETY_ASSERT(iV != INVALID_IND, "invalid vertex index in face " + std::to_string(iF));
+      heVertexArr[3 * iF + k] = iV;
+      nV = std::max(nV, iV + 1);
+    }
+    if (triangles[iF][0] == triangles[iF][1] || triangles[iF][1] == triangles[iF][2] ||
+        triangles[iF][2] == triangles[iF][0]) {
+      throw std::runtime_error("face " + std::to_string(iF) + " has a repeated vertex");
+    }
+  }
+
+  buildTwins(nV);
+  buildVertexHalfedges(nV);
+}
+
+CompactTriangleMesh::CompactTriangleMesh(HalfedgeMesh& mesh) {
+  if (!mesh.isTriangular()) throw std::runtime_error("CompactTriangleMesh requires a triangular mesh");
+
+  VertexData<size_t> vInd = mesh.getVertexIndices();
+  FaceData<size_t> fInd = mesh.getFaceIndices();
+
+  // Assign each interior halfedge its slot
+  HalfedgeData<size_t> heSlot(mesh, INVALID_IND);
+  heVertexArr.resize(3 * mesh.nFaces());
+  for (Face f : mesh.faces()) {
+    size_t k = 0;
+    for (Halfedge he : f.adjacentHalfedges()) {
+      size_t iHe = 3 * fInd[f] + k;
+      heSlot[he] = iHe;
+      heVertexArr[iHe] = vInd[he.vertex()];
+      k++;
+    }
+  }
+
+  // Twins come directly from the input mesh
+  heTwinArr.resize(heVertexArr.size());
+  for (Face f : mesh.faces()) {
+    for (Halfedge he : f.adjacentHalfedges()) {
+      heTwinArr[heSlot[he]] = heSlot[he.twin()]; // INVALID_IND for exterior halfedges
+    }
+  }
+
+  buildVertexHalfedges(mesh.nVertices());
+}
+
+void CompactTriangleMesh::buildTwins(size_t nV) {
+
+  // Gather the outgoing halfedges from each vertex as (tip, halfedge) pairs, sorted by tip
+  size_t nH = heVertexArr.size();
+  std::vector<size_t> vertexOutStart(nV + 1, 0);
+  for (size_t iHe = 0; iHe < nH; iHe++) {
+    vertexOutStart[heVertexArr[iHe] + 1]++;
+  }
+  for (size_t iV = 0; iV < nV; iV++) {
+    vertexOutStart[iV + 1] += vertexOutStart[iV];
+  }
+  std::vector<std::pair<size_t, size_t>> vertexOut(nH);
+  {
+    std::vector<size_t> fill(vertexOutStart.begin(), vertexOutStart.end() - 1);
+    for (size_t iHe = 0; iHe < nH; iHe++) {
+      vertexOut[fill[heVertexArr[iHe]]++] = std::make_pair(heTipVertex(iHe), iHe);
+    }
+  }
+  for (size_t iV = 0; iV < nV; iV++) {
+    auto begin = vertexOut.begin() + vertexOutStart[iV];
+    auto end = vertexOut.begin() + vertexOutStart[iV + 1];
+    std::sort(begin, end);
+    for (auto it = begin; it != end && it + 1 != end; ++it) {
+      if (it->first == (it + 1)->first) {
+        throw std::runtime_error("Halfedge (" + std::to_string(iV) + "," + std::to_string(it->first) +
+                                 ") appears more than once in the input. Mesh is nonmanifold or has inconsistent "
+                                 "face orientation.");
+      }
+    }
+  }
+
+  // The twin of (v -> w) is (w -> v), if it exists
+  heTwinArr.resize(nH);
+  for (size_t iHe = 0; iHe < nH; iHe++) {
+    size_t tail = heVertexArr[iHe];
+    size_t tip = heTipVertex(iHe);
+    auto begin = vertexOut.begin() + vertexOutStart[tip];
+    auto end = vertexOut.begin() + vertexOutStart[tip + 1];
+    auto it = std::lower_bound(begin, end, std::make_pair(tail, size_t(0)));
+    heTwinArr[iHe] = (it != end && it->first == tail) ? it->second : INVALID_IND;
+  }
+}
+
+void CompactTriangleMesh::buildVertexHalfedges(size_t nV) {
+
+  // Any outgoing halfedge will do for interior vertices, but boundary vertices must point along the boundary
+  vHalfedgeArr = std::vector<size_t>(nV, INVALID_IND);
+  for (size_t iHe = 0; iHe < heVertexArr.size(); iHe++) {
+    size_t iV = heVertexArr[iHe];
+    if (vHalfedgeArr[iV] == INVALID_IND || heIsBoundary(iHe)) {
+      if (vHalfedgeArr[iV] != INVALID_IND && heIsBoundary(vHalfedgeArr[iV])) {
+        throw std::runtime_error("vertex " + std::to_string(iV) + " appears in more than one boundary loop");
+      }
+      vHalfedgeArr[iV] = iHe;
+    }
+  }
+  for (size_t iV = 0; iV < nV; iV++) {
+    if (vHalfedgeArr[iV] == INVALID_IND) {
+      throw std::runtime_error("vertex " + std::to_string(iV) + " is not used by any face");
+    }
+  }
+
+  // Make sure the faces around each vertex form a single fan
+  std::vector<size_t> vertexDegree(nV, 0);
+  for (size_t iHe = 0; iHe < heVertexArr.size(); iHe++) {
+    vertexDegree[heVertexArr[iHe]]++;
+  }
+  for (size_t iV = 0; iV < nV; iV++) {
+    size_t count = 0;
+    size_t iHe = vHalfedgeArr[iV];
+    do {
+      count++;
+      iHe = vNextOutgoing(iHe);
+    } while (iHe != INVALID_IND && iHe != vHalfedgeArr[iV] && count <= vertexDegree[iV]);
+    if (count != vertexDegree[iV]) {
+      throw std::runtime_error("vertex " + std::to_string(iV) + " is nonmanifold");
+    }
+  }
+}
+
+void CompactTriangleMesh::setTwins(size_t iHeA, size_t iHeB) {
+  if (iHeA != INVALID_IND) heTwinArr[iHeA] = iHeB;
+  if (iHeB != INVALID_IND) heTwinArr[iHeB] = iHeA;
+}
+
+size_t CompactTriangleMesh::getNewFace() {
+  size_t iF = nFaces();
+  heVertexArr.resize(3 * (iF + 1), INVALID_IND);
+  heTwinArr.resize(3 * (iF + 1), INVALID_IND);
+  return iF;
+}
+
+size_t CompactTriangleMesh::getNewVertex() {
+  vHalfedgeArr.push_back(INVALID_IND);
+  return vHalfedgeArr.size() - 1;
+}
+
+bool CompactTriangleMesh::flip(size_t iHe) {
+
+  // Halfedges of the first face, (v0 -> v1 -> v2)
+  size_t ha0 = iHe;
+  size_t ha1 = heNext(ha0);
+  size_t ha2 = heNext(ha1);
+
+  // Halfedges of the second face, (v1 -> v0 -> v3)
+  size_t hb0 = heTwinArr[ha0];
+  if (hb0 == INVALID_IND) return false;
+  size_t hb1 = heNext(hb0);
+  size_t hb2 = heNext(hb1);
+
+  size_t v0 = heVertexArr[ha0];
+  size_t v1 = heVertexArr[ha1];
+  size_t v2 = heVertexArr[ha2];
+  size_t v3 = heVertexArr[hb2];
+  if (v2 == v3) return false;
+
+  size_t ta1 = heTwinArr[ha1];
+  size_t ta2 = heTwinArr[ha2];
+  size_t tb1 = heTwinArr[hb1];
+  size_t tb2 = heTwinArr[hb2];
+
+  // The faces become (v2 -> v3 -> v1) and (v3 -> v2 -> v0). Each outer halfedge moves to a new slot, keeping its twin.
+  heVertexArr[ha0] = v2;
+  heVertexArr[ha1] = v3;
+  heVertexArr[ha2] = v1;
+  heVertexArr[hb0] = v3;
+  heVertexArr[hb1] = v2;
+  heVertexArr[hb2] = v0;
+  setTwins(ha1, tb2);
+  setTwins(ha2, ta1);
+  setTwins(hb1, ta2);
+  setTwins(hb2, tb1);
+
+  // Update vertex pointers, following the outer halfedges to their new slots (which preserves the boundary invariant)
+  auto newSlot = [&](size_t iHeOld) {
+    if (iHeOld == ha0) return hb2;
+    if (iHeOld == hb0) return ha2;
+    if (iHeOld == ha1) return ha2;
+    if (iHeOld == ha2) return hb1;
+    if (iHeOld == hb1) return hb2;
+    if (iHeOld == hb2) return ha1;
+    return iHeOld;
+  };
+  for (size_t iV : {v0, v1, v2, v3}) {
+    vHalfedgeArr[iV] = newSlot(vHalfedgeArr[iV]);
+  }
+
+  return true;
+}
+
+size_t CompactTriangleMesh::splitEdge(size_t iHe) {
+
+  // Halfedges of the first face, (v0 -> v1 -> v2)
+  size_t ha0 = iHe;
+  size_t ha1 = heNext(ha0);
+  size_t ha2 = heNext(ha1);
+  size_t v1 = heVertexArr[ha1];
+  size_t v2 = heVertexArr[ha2];
+  size_t ta1 = heTwinArr[ha1];
+
+  size_t vm = getNewVertex();
+
+  // First face becomes (v0 -> m -> v2), and the new face is (m -> v1 -> v2)
+  size_t fNewA = getNewFace();
+  size_t hn0 = fHalfedge(fNewA);
+  size_t hn1 = heNext(hn0);
+  size_t hn2 = heNext(hn1);
+  heVertexArr[ha1] = vm;
+  heVertexArr[hn0] = vm;
+  heVertexArr[hn1] = v1;
+  heVertexArr[hn2] = v2;
+  setTwins(hn1, ta1);
+  setTwins(ha1, hn2);
+  if (vHalfedgeArr[v1] == ha1) vHalfedgeArr[v1] = hn1;
+
+  // Second face (v1 -> v0 -> v3) becomes (m -> v0 -> v3), and the new face is (v1 -> m -> v3)
+  size_t hb0 = heTwinArr[ha0];
+  if (hb0 != INVALID_IND) {
+    size_t hb1 = heNext(hb0);
+    size_t hb2 = heNext(hb1);
+    size_t v3 = heVertexArr[hb2];
+    size_t tb2 = heTwinArr[hb2];
+
+    size_t fNewB = getNewFace();
+    size_t hp0 = fHalfedge(fNewB);
+    size_t hp1 = heNext(hp0);
+    size_t hp2 = heNext(hp1);
+    heVertexArr[hb0] = vm;
+    heVertexArr[hp0] = v1;
+    heVertexArr[hp1] = vm;
+    heVertexArr[hp2] = v3;
+    setTwins(hp2, tb2);
+    setTwins(hb2, hp1);
+    setTwins(hn0, hp0);
+    if (vHalfedgeArr[v1] == hb0) vHalfedgeArr[v1] = hp0;
+  }
+
+  // (ha0 and hb0 are still twins)
+  // On the boundary, hn0 is the outgoing boundary halfedge from m
+  vHalfedgeArr[vm] = hn0;
+
+  return vm;
+}
+
+size_t CompactTriangleMesh::insertVertex(size_t iF) {
+
+  // Halfedges of the face, (a -> b -> c)
+  size_t h0 = fHalfedge(iF);
+  size_t h1 = heNext(h0);
+  size_t h2 = heNext(h1);
+  size_t va = heVertexArr[h0];
+  size_t vb = heVertexArr[h1];
+  size_t vc = heVertexArr[h2];
+  size_t t1 = heTwinArr[h1];
+  size_t t2 = heTwinArr[h2];
+
+  size_t vm = getNewVertex();
+
+  // The faces become (a -> b -> m), (b -> c -> m) and (c -> a -> m)
+  size_t fB = getNewFace();
+  size_t fC = getNewFace();
+  size_t hb0 = fHalfedge(fB);
+  size_t hb1 = heNext(hb0);
+  size_t hb2 = heNext(hb1);
+  size_t hc0 = fHalfedge(fC);
+  size_t hc1 = heNext(hc0);
+  size_t hc2 = heNext(hc1);
+
+  heVertexArr[h2] = vm;
+  heVertexArr[hb0] = vb;
+  heVertexArr[hb1] = vc;
+  heVertexArr[hb2] = vm;
+  heVertexArr[hc0] = vc;
+  heVertexArr[hc1] = va;
+  heVertexArr[hc2] = vm;
+
+  setTwins(hb0, t1);
+  setTwins(hc0, t2);
+  setTwins(h1, hb2);
+  setTwins(hb1, hc2);
+  setTwins(hc1, h2);
+
+  if (vHalfedgeArr[vb] == h1) vHalfedgeArr[vb] = hb0;
+  if (vHalfedgeArr[vc] == h2) vHalfedgeArr[vc] = hc0;
+  vHalfedgeArr[vm] = h2;
+
+  return vm;
+}
+
+std::vector<std::array<size_t, 3>> CompactTriangleMesh::getFaceVertexList() const {
+  std::vector<std::array<size_t, 3>> triangles(nFaces());
+  for (size_t iF = 0; iF < nFaces(); iF++) {
+    for (size_t k = 0; k < 3; k++) {
+      triangles[iF][k] = heVertexArr[3 * iF + k];
+    }
+  }
+  return triangles;
+}
+
+std::unique_ptr<HalfedgeMesh> CompactTriangleMesh::toHalfedgeMesh() const {
+  return std::unique_ptr<HalfedgeMesh>(new HalfedgeMesh(getFaceVertexList()));
+}
+
+void CompactTriangleMesh::validateConnectivity() const {
+
+  size_t nH = nHalfedges();
+  size_t nV = nVertices();
+  if (nH % 3 != 0) throw std::logic_error("halfedge count is not a multiple of 3");
+  if (heTwinArr.size() != nH) throw std::logic_error("twin array size does not match halfedge count");
+
+  // Halfedges
+  for (size_t iHe = 0; iHe < nH; iHe++) {
+    std::string msg = "he " + std::to_string(iHe);
+    if (heVertexArr[iHe] >= nV) throw std::logic_error(msg + " - bad vertex reference");
+    if (heVertexArr[iHe] == heTipVertex(iHe)) throw std::logic_error(msg + " - degenerate halfedge");
+    size_t iTwin = heTwinArr[iHe];
+    if (iTwin == INVALID_IND) continue;
+    if (iTwin >= nH) throw std::logic_error(msg + " - bad twin reference");
+    if (heTwinArr[iTwin] != iHe) throw std::logic_error(msg + " - twin is not symmetric");
+    if (heVertexArr[iTwin] != heTipVertex(iHe) || heTipVertex(iTwin) != heVertexArr[iHe]) {
+      throw std::logic_error(msg + " - twin has wrong vertices");
+    }
+  }
+
+  // Vertices; each outgoing halfedge should be visited exactly once by the orbits
+  std::vector<char> halfedgeSeen(nH, false);
+  for (size_t iV = 0; iV < nV; iV++) {
+    std::string msg = "v " + std::to_string(iV);
+    size_t iHeStart = vHalfedgeArr[iV];
+    if (iHeStart >= nH) throw std::logic_error(msg + " - bad halfedge reference");
+    size_t iHe = iHeStart;
+    do {
+      if (heVertexArr[iHe] != iV) throw std::logic_error(msg + " - outgoing halfedge does not start at vertex");
+      if (halfedgeSeen[iHe]) throw std::logic_error(msg + " - orbit does not close");
+      halfedgeSeen[iHe] = true;
+      iHe = vNextOutgoing(iHe);
+    } while (iHe != INVALID_IND && iHe != iHeStart);
+  }
+  for (size_t iHe = 0; iHe < nH; iHe++) {
+    if (!halfedgeSeen[iHe]) {
+      throw std::logic_error("he " + std::to_string(iHe) + " - not reached from its vertex (bad boundary halfedge?)");
+    }
+  }
+}
+
+} // namespace surface
+} // namespace geometrycentral
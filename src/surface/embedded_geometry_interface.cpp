@@ -1,5 +1,8 @@
 #include "geometrycentral/surface/embedded_geometry_interface.h"
 
+#include "geometrycentral/utilities/triangle_kernels.h"
+
+#include <algorithm>
 #include <limits>
 
 using std::cout;
@@ -8,6 +11,204 @@ using std::endl;
 namespace geometrycentral {
 namespace surface {
 
+namespace {
+
+// Per-element computations, shared by the compute*() functions below and markVerticesChanged()
+
+double edgeLengthFromPositions(const VertexData<Vector3>& vertexPositions, Edge e) {
+  return norm(vertexPositions[e.halfedge().vertex()] - vertexPositions[e.halfedge().twin().vertex()]);
+}
+
+// Area of a triangle
+double triangleArea(Vector3 pA, Vector3 pB, Vector3 pC) { return 0.5 * norm(cross(pB - pA, pC - pA)); }
+
+// Angle of a triangle at pA
+double triangleAngle(Vector3 pA, Vector3 pB, Vector3 pC) {
+  double q = dot(unit(pB - pA), unit(pC - pA));
+  q = clamp(q, -1.0, 1.0);
+  return std::acos(q);
+}
+
+// Half the cotangent of the angle of a triangle at pA
+double triangleHalfCotan(Vector3 pA, Vector3 pB, Vector3 pC) {
+  Vector3 vecR = pB - pA;
+  Vector3 vecL = pC - pA;
+
+  double cotValue = dot(vecR, vecL) / norm(cross(vecR, vecL));
+  return cotValue / 2;
+}
+
+double faceAreaFromPositions(const VertexData<Vector3>& vertexPositions, Face f) {
+  // WARNING: Logic duplicated between cached and immediate version
+  Halfedge he = f.halfedge();
+  Vector3 pA = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pB = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pC = vertexPositions[he.vertex()];
+
+  GC_SAFETY_ASSERT(he.next() == f.halfedge(), "faces mush be triangular");
+
+  return triangleArea(pA, pB, pC);
+}
+
+double cornerAngleFromPositions(const VertexData<Vector3>& vertexPositions, Corner c) {
+  // WARNING: Logic duplicated between cached and immediate version
+  Halfedge he = c.halfedge();
+  Vector3 pA = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pB = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pC = vertexPositions[he.vertex()];
+
+  GC_SAFETY_ASSERT(he.next() == c.halfedge(), "faces mush be triangular");
+
+  return triangleAngle(pA, pB, pC);
+}
+
+// Half the cotangent of the angle opposite an interior halfedge
+double halfCotanFromPositions(const VertexData<Vector3>& vertexPositions, Halfedge heI) {
+  // WARNING: Logic duplicated between cached and immediate version
+  Halfedge he = heI;
+  Vector3 pB = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pC = vertexPositions[he.vertex()];
+  he = he.next();
+  Vector3 pA = vertexPositions[he.vertex()];
+  GC_SAFETY_ASSERT(he.next() == heI, "faces mush be triangular");
+
+  return triangleHalfCotan(pA, pB, pC);
+}
+
+double halfedgeCotanWeightFromPositions(const VertexData<Vector3>& vertexPositions, Halfedge he) {
+  double cotSum = 0.;
+  if (he.isInterior()) {
+    cotSum += halfCotanFromPositions(vertexPositions, he);
+  }
+  return cotSum;
+}
+
+double edgeCotanWeightFromPositions(const VertexData<Vector3>& vertexPositions, Edge e) {
+  double cotSum = 0.;
+  cotSum += halfCotanFromPositions(vertexPositions, e.halfedge()); // first halfedge-- always real
+  if (e.halfedge().twin().isInterior()) {
+    cotSum += halfCotanFromPositions(vertexPositions, e.halfedge().twin());
+  }
+  return cotSum;
+}
+
+Vector3 faceNormalFromPositions(const VertexData<Vector3>& vertexPositions, Face f) {
+
+  // For general polygons, take the sum of the cross products at each corner
+  Vector3 normalSum = Vector3::zero();
+  for (Halfedge heF : f.adjacentHalfedges()) {
+
+    // Gather vertex positions for next three vertices
+    Halfedge he = heF;
+    Vector3 pA = vertexPositions[he.vertex()];
+    he = he.next();
+    Vector3 pB = vertexPositions[he.vertex()];
+    he = he.next();
+    Vector3 pC = vertexPositions[he.vertex()];
+
+    normalSum += cross(pB - pA, pC - pA);
+
+    // In the special case of a triangle, there is no need to to repeat at all three corners; the result will be the
+    // same
+    if (he.next() == heF) break;
+  }
+
+  return unit(normalSum);
+}
+
+Vector3 vertexNormalFromFaces(const FaceData<Vector3>& faceNormals, const CornerData<double>& cornerAngles, Vertex v) {
+  Vector3 normalSum = Vector3::zero();
+
+  for (Corner c : v.adjacentCorners()) {
+    Vector3 normal = faceNormals[c.face()];
+    double weight = cornerAngles[c];
+
+    normalSum += weight * normal;
+  }
+
+  return unit(normalSum);
+}
+
+template <typename E>
+void sortAndRemoveDuplicates(std::vector<E>& elements) {
+  std::sort(elements.begin(), elements.end());
+  elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+}
+
+// Evaluate the batched triangle kernels (see triangle_kernels.h) on the faces of the mesh, a chunk at a time. For each
+// chunk, the requested outputs are computed into scratch space, then passed to processTriangles(faces, results) along
+// with the faces, in order. Any faces which are not triangles are passed to processPolygon(f) instead.
+template <typename TriangleFunc, typename PolygonFunc>
+void evaluateTriangleChunks(HalfedgeMesh& mesh, const VertexData<Vector3>& vertexPositions, bool wantAreas,
+                            bool wantNormals, bool wantAnglesAndCotans, TriangleFunc processTriangles,
+                            PolygonFunc processPolygon) {
+  const size_t chunkSize = 256; // small enough that the scratch space stays in cache
+
+  std::vector<double> positionBuffer(9 * chunkSize);
+  TriangleBatch batch;
+  for (int i = 0; i < 3; i++) {
+    for (int d = 0; d < 3; d++) {
+      batch.positions[i][d] = &positionBuffer[(3 * i + d) * chunkSize];
+    }
+  }
+
+  std::vector<double> resultBuffer(10 * chunkSize);
+  TriangleBatchOutputs results;
+  if (wantAreas) {
+    results.areas = &resultBuffer[0];
+  }
+  for (int i = 0; i < 3; i++) {
+    if (wantNormals) {
+      results.normals[i] = &resultBuffer[(1 + i) * chunkSize];
+    }
+    if (wantAnglesAndCotans) {
+      results.angles[i] = &resultBuffer[(4 + i) * chunkSize];
+      results.halfCotans[i] = &resultBuffer[(7 + i) * chunkSize];
+    }
+  }
+
+  std::vector<Face> faces;
+  faces.reserve(chunkSize);
+  auto evaluateChunk = [&]() {
+    batch.size = faces.size();
+    evaluateTriangleBatch(batch, results);
+    processTriangles(faces, results);
+    faces.clear();
+  };
+
+  for (Face f : mesh.faces()) {
+    if (!f.isTriangle()) {
+      processPolygon(f);
+      continue;
+    }
+
+    size_t j = faces.size();
+    Halfedge he = f.halfedge();
+    for (int i = 0; i < 3; i++) {
+      Vector3 p = vertexPositions[he.vertex()];
+      for (int d = 0; d < 3; d++) {
+        positionBuffer[(3 * i + d) * chunkSize + j] = p[d];
+      }
+      he = he.next();
+    }
+
+    faces.push_back(f);
+    if (faces.size() == chunkSize) {
+      evaluateChunk();
+    }
+  }
+  if (!faces.empty()) {
+    evaluateChunk();
+  }
+}
+
+} // namespace
+
 // clang-format off
 EmbeddedGeometryInterface::EmbeddedGeometryInterface(HalfedgeMesh& mesh_) : 
   ExtrinsicGeometryInterface(mesh_),
@@ -29,7 +230,7 @@ void EmbeddedGeometryInterface::computeEdgeLengths() {
 
   edgeLengths = EdgeData<double>(mesh);
   for (Edge e : mesh.edges()) {
-    edgeLengths[e] = norm(vertexPositions[e.halfedge().vertex()] - vertexPositions[e.halfedge().twin().vertex()]);
+    edgeLengths[e] = edgeLengthFromPositions(vertexPositions, e);
   }
 }
 
@@ -62,31 +263,14 @@ void EmbeddedGeometryInterface::computeFaceNormals() {
   vertexPositionsQ.ensureHave();
 
   faceNormals = FaceData<Vector3>(mesh);
-
-  for (Face f : mesh.faces()) {
-
-    // For general polygons, take the sum of the cross products at each corner
-    Vector3 normalSum = Vector3::zero();
-    for (Halfedge heF : f.adjacentHalfedges()) {
-
-      // Gather vertex positions for next three vertices
-      Halfedge he = heF;
-      Vector3 pA = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pB = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pC = vertexPositions[he.vertex()];
-
-      normalSum += cross(pB - pA, pC - pA);
-
-      // In the special case of a triangle, there is no need to to repeat at all three corners; the result will be the
-      // same
-      if (he.next() == heF) break;
-    }
-
-    Vector3 normal = unit(normalSum);
-    faceNormals[f] = normal;
-  }
+  evaluateTriangleChunks(
+      mesh, vertexPositions, false, true, false,
+      [&](const std::vector<Face>& faces, const TriangleBatchOutputs& results) {
+        for (size_t j = 0; j < faces.size(); j++) {
+          faceNormals[faces[j]] = Vector3{results.normals[0][j], results.normals[1][j], results.normals[2][j]};
+        }
+      },
+      [&](Face f) { faceNormals[f] = faceNormalFromPositions(vertexPositions, f); });
 }
 void EmbeddedGeometryInterface::requireFaceNormals() { faceNormalsQ.require(); }
 void EmbeddedGeometryInterface::unrequireFaceNormals() { faceNormalsQ.unrequire(); }
@@ -97,18 +281,8 @@ void EmbeddedGeometryInterface::computeVertexNormals() {
   cornerAnglesQ.ensureHave();
 
   vertexNormals = VertexData<Vector3>(mesh);
-
   for (Vertex v : mesh.vertices()) {
-    Vector3 normalSum = Vector3::zero();
-
-    for (Corner c : v.adjacentCorners()) {
-      Vector3 normal = faceNormals[c.face()];
-      double weight = cornerAngles[c];
-
-      normalSum += weight * normal;
-    }
-
-    vertexNormals[v] = unit(normalSum);
+    vertexNormals[v] = vertexNormalFromFaces(faceNormals, cornerAngles, v);
   }
 }
 void EmbeddedGeometryInterface::requireVertexNormals() { vertexNormalsQ.require(); }
@@ -193,21 +367,8 @@ void EmbeddedGeometryInterface::computeFaceAreas() {
   vertexPositionsQ.ensureHave();
 
   faceAreas = FaceData<double>(mesh);
-
   for (Face f : mesh.faces()) {
-
-    // WARNING: Logic duplicated between cached and immediate version
-    Halfedge he = f.halfedge();
-    Vector3 pA = vertexPositions[he.vertex()];
-    he = he.next();
-    Vector3 pB = vertexPositions[he.vertex()];
-    he = he.next();
-    Vector3 pC = vertexPositions[he.vertex()];
-
-    GC_SAFETY_ASSERT(he.next() == f.halfedge(), "faces mush be triangular");
-
-    double area = 0.5 * norm(cross(pB - pA, pC - pA));
-    faceAreas[f] = area;
+    faceAreas[f] = faceAreaFromPositions(vertexPositions, f);
   }
 }
 
@@ -216,106 +377,245 @@ void EmbeddedGeometryInterface::computeCornerAngles() {
   vertexPositionsQ.ensureHave();
 
   cornerAngles = CornerData<double>(mesh);
-
   for (Corner c : mesh.corners()) {
+    cornerAngles[c] = cornerAngleFromPositions(vertexPositions, c);
+  }
+}
 
-    // WARNING: Logic duplicated between cached and immediate version
-    Halfedge he = c.halfedge();
-    Vector3 pA = vertexPositions[he.vertex()];
-    he = he.next();
-    Vector3 pB = vertexPositions[he.vertex()];
-    he = he.next();
-    Vector3 pC = vertexPositions[he.vertex()];
-
-    GC_SAFETY_ASSERT(he.next() == c.halfedge(), "faces mush be triangular");
 
-    double q = dot(unit(pB - pA), unit(pC - pA));
-    q = clamp(q, -1.0, 1.0);
-    double angle = std::acos(q);
+// Override to compute directly from vertex positions
+void EmbeddedGeometryInterface::computeHalfedgeCotanWeights() {
+  vertexPositionsQ.ensureHave();
 
-    cornerAngles[c] = angle;
+  halfedgeCotanWeights = HalfedgeData<double>(mesh);
+  for (Halfedge he : mesh.halfedges()) {
+    halfedgeCotanWeights[he] = halfedgeCotanWeightFromPositions(vertexPositions, he);
   }
 }
 
 
 // Override to compute directly from vertex positions
-void EmbeddedGeometryInterface::computeHalfedgeCotanWeights() {
+void EmbeddedGeometryInterface::computeEdgeCotanWeights() {
   vertexPositionsQ.ensureHave();
 
-  halfedgeCotanWeights = HalfedgeData<double>(mesh);
+  edgeCotanWeights = EdgeData<double>(mesh);
+  for (Edge e : mesh.edges()) {
+    edgeCotanWeights[e] = edgeCotanWeightFromPositions(vertexPositions, e);
+  }
+}
 
-  for (Halfedge heI : mesh.halfedges()) {
 
-    // WARNING: Logic duplicated between cached and immediate version
-    double cotSum = 0.;
+// Override to compute directly from vertex positions, with the batched triangle kernels. These do the same arithmetic
+// as the separate versions above, so the results are identical.
+void EmbeddedGeometryInterface::computeTriangleQuantities() {
+  if (faceAreasQ.computed && vertexDualAreasQ.computed && cornerAnglesQ.computed && halfedgeCotanWeightsQ.computed &&
+      edgeCotanWeightsQ.computed) {
+    return;
+  }
+  vertexPositionsQ.ensureHave();
 
-    if (heI.isInterior()) {
-      Halfedge he = heI;
-      Vector3 pB = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pC = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pA = vertexPositions[he.vertex()];
-      GC_SAFETY_ASSERT(he.next() == heI, "faces mush be triangular");
+  FaceData<double> newFaceAreas(mesh);
+  VertexData<double> newVertexDualAreas(mesh, 0.);
+  CornerData<double> newCornerAngles(mesh);
+  HalfedgeData<double> newHalfedgeCotanWeights(mesh, 0.);
+  EdgeData<double> newEdgeCotanWeights(mesh, 0.);
+
+  evaluateTriangleChunks(
+      mesh, vertexPositions, true, false, true,
+      [&](const std::vector<Face>& faces, const TriangleBatchOutputs& results) {
+        for (size_t j = 0; j < faces.size(); j++) {
+          double area = results.areas[j];
+          newFaceAreas[faces[j]] = area;
+
+          Halfedge he = faces[j].halfedge();
+          for (int i = 0; i < 3; i++) {
+            newVertexDualAreas[he.vertex()] += area / 3.0;
+            newCornerAngles[he.corner()] = results.angles[i][j];
+            newHalfedgeCotanWeights[he] = results.halfCotans[i][j];
+            newEdgeCotanWeights[he.edge()] += results.halfCotans[i][j];
+            he = he.next();
+          }
+        }
+      },
+      [](Face) { GC_SAFETY_ASSERT(false, "faces mush be triangular"); });
+
+  // Store the results, except for any quantities which were computed separately in the meantime
+  faceAreasQ.ensureHaveWith([&]() { faceAreas = std::move(newFaceAreas); });
+  vertexDualAreasQ.ensureHaveWith([&]() { vertexDualAreas = std::move(newVertexDualAreas); });
+  cornerAnglesQ.ensureHaveWith([&]() { cornerAngles = std::move(newCornerAngles); });
+  halfedgeCotanWeightsQ.ensureHaveWith([&]() { halfedgeCotanWeights = std::move(newHalfedgeCotanWeights); });
+  edgeCotanWeightsQ.ensureHaveWith([&]() { edgeCotanWeights = std::move(newEdgeCotanWeights); });
+}
 
-      Vector3 vecR = pB - pA;
-      Vector3 vecL = pC - pA;
 
-      double cotValue = dot(vecR, vecL) / norm(cross(vecR, vecL));
-      cotSum += cotValue / 2;
-    }
+// == Incremental updates
 
-    halfedgeCotanWeights[heI] = cotSum;
-  }
+void EmbeddedGeometryInterface::updateVertexPositions(const std::vector<Vertex>&) {
+  computeVertexPositions();
 }
 
+void EmbeddedGeometryInterface::markVerticesChanged(const std::vector<Vertex>& changedVertices) {
 
-// Override to compute directly from vertex positions
-void EmbeddedGeometryInterface::computeEdgeCotanWeights() {
-  vertexPositionsQ.ensureHave();
+  // Everything else is derived from the positions, so without them there is nothing to update locally
+  if (!vertexPositionsQ.computed) {
+    refreshQuantities();
+    return;
+  }
 
-  edgeCotanWeights = EdgeData<double>(mesh);
+  // Gather the elements whose values may change. Edge lengths change only on the edges incident on a changed vertex,
+  // but the other quantities change throughout the incident faces, and at every vertex of those faces.
+  std::vector<Edge> incidentEdges;
+  std::vector<Face> incidentFaces;
+  for (Vertex v : changedVertices) {
+    for (Edge e : v.adjacentEdges()) {
+      incidentEdges.push_back(e);
+    }
+    for (Face f : v.adjacentFaces()) {
+      incidentFaces.push_back(f);
+    }
+  }
+  sortAndRemoveDuplicates(incidentEdges);
+  sortAndRemoveDuplicates(incidentFaces);
+
+  std::vector<Halfedge> faceHalfedges;
+  std::vector<Edge> faceEdges;
+  std::vector<Vertex> faceVertices;
+  for (Face f : incidentFaces) {
+    for (Halfedge he : f.adjacentHalfedges()) {
+      faceHalfedges.push_back(he);
+      faceEdges.push_back(he.edge());
+      faceVertices.push_back(he.vertex());
+    }
+  }
+  sortAndRemoveDuplicates(faceEdges);
+  sortAndRemoveDuplicates(faceVertices);
+
+  // Indices depend only on the connectivity, so they are still valid. The triangle quantities group has no data of its
+  // own, only members which are updated below.
+  std::vector<DependentQuantity*> updated{&vertexIndicesQ,       &interiorVertexIndicesQ, &edgeIndicesQ,
+                                          &halfedgeIndicesQ,     &cornerIndicesQ,         &faceIndicesQ,
+                                          &boundaryLoopIndicesQ, &triangleQuantitiesQ};
+
+  // Update each quantity which has been computed, in order of dependence
+  updateVertexPositions(changedVertices);
+  updated.push_back(&vertexPositionsQ);
+
+  if (edgeLengthsQ.computed) {
+    for (Edge e : incidentEdges) {
+      edgeLengths[e] = edgeLengthFromPositions(vertexPositions, e);
+    }
+    updated.push_back(&edgeLengthsQ);
+  }
 
-  for (Edge e : mesh.edges()) {
+  if (faceAreasQ.computed) {
+    for (Face f : incidentFaces) {
+      faceAreas[f] = faceAreaFromPositions(vertexPositions, f);
+    }
+    updated.push_back(&faceAreasQ);
+  }
 
-    // WARNING: Logic duplicated between cached and immediate version
-    double cotSum = 0.;
+  if (cornerAnglesQ.computed) {
+    for (Halfedge he : faceHalfedges) {
+      cornerAngles[he.corner()] = cornerAngleFromPositions(vertexPositions, he.corner());
+    }
+    updated.push_back(&cornerAnglesQ);
+  }
 
-    { // First halfedge-- always real
-      Halfedge he = e.halfedge();
-      Vector3 pB = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pC = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pA = vertexPositions[he.vertex()];
-      GC_SAFETY_ASSERT(he.next() == e.halfedge(), "faces mush be triangular");
+  if (halfedgeCotanWeightsQ.computed) {
+    for (Halfedge he : faceHalfedges) {
+      halfedgeCotanWeights[he] = halfedgeCotanWeightFromPositions(vertexPositions, he);
+    }
+    updated.push_back(&halfedgeCotanWeightsQ);
+  }
 
-      Vector3 vecR = pB - pA;
-      Vector3 vecL = pC - pA;
+  if (edgeCotanWeightsQ.computed) {
+    for (Edge e : faceEdges) {
+      edgeCotanWeights[e] = edgeCotanWeightFromPositions(vertexPositions, e);
+    }
+    updated.push_back(&edgeCotanWeightsQ);
+  }
 
-      double cotValue = dot(vecR, vecL) / norm(cross(vecR, vecL));
-      cotSum += cotValue / 2;
+  if (faceNormalsQ.computed) {
+    for (Face f : incidentFaces) {
+      faceNormals[f] = faceNormalFromPositions(vertexPositions, f);
     }
+    updated.push_back(&faceNormalsQ);
+  }
 
-    if (e.halfedge().twin().isInterior()) { // Second halfedge
-      Halfedge he = e.halfedge().twin();
-      Vector3 pB = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pC = vertexPositions[he.vertex()];
-      he = he.next();
-      Vector3 pA = vertexPositions[he.vertex()];
+  if (vertexDualAreasQ.computed && faceAreasQ.computed) {
+    for (Vertex v : faceVertices) {
+      double dualArea = 0.;
+      for (Face f : v.adjacentFaces()) {
+        dualArea += faceAreas[f] / 3.0;
+      }
+      vertexDualAreas[v] = dualArea;
+    }
+    updated.push_back(&vertexDualAreasQ);
+  }
+
+  if (vertexAngleSumsQ.computed && cornerAnglesQ.computed) {
+    for (Vertex v : faceVertices) {
+      double angleSum = 0.;
+      for (Corner c : v.adjacentCorners()) {
+        angleSum += cornerAngles[c];
+      }
+      vertexAngleSums[v] = angleSum;
+    }
+    updated.push_back(&vertexAngleSumsQ);
+  }
 
-      Vector3 vecR = pB - pA;
-      Vector3 vecL = pC - pA;
+  if (vertexNormalsQ.computed && faceNormalsQ.computed && cornerAnglesQ.computed) {
+    for (Vertex v : faceVertices) {
+      vertexNormals[v] = vertexNormalFromFaces(faceNormals, cornerAngles, v);
+    }
+    updated.push_back(&vertexNormalsQ);
+  }
+
+  // The sparsity pattern of the Laplacian does not change, so patch the values in place. Only edges of the incident
+  // faces change weight, so only the columns of their vertices change; rebuild each of those columns.
+  if (cotanLaplacianQ.computed && edgeCotanWeightsQ.computed && vertexIndicesQ.computed) {
+    for (Vertex v : faceVertices) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(cotanLaplacian, vertexIndices[v]); it; ++it) {
+        it.valueRef() = 0.;
+      }
+    }
+    for (Vertex v : faceVertices) {
+      size_t iV = vertexIndices[v];
+      for (Edge e : v.adjacentEdges()) {
+        size_t iVTail = vertexIndices[e.halfedge().vertex()];
+        size_t iVHead = vertexIndices[e.halfedge().twin().vertex()];
+        double weight = edgeCotanWeights[e];
+        if (iVTail == iV) {
+          cotanLaplacian.coeffRef(iVTail, iVTail) += weight;
+          cotanLaplacian.coeffRef(iVHead, iVTail) -= weight;
+        }
+        if (iVHead == iV) {
+          cotanLaplacian.coeffRef(iVHead, iVHead) += weight;
+          cotanLaplacian.coeffRef(iVTail, iVHead) -= weight;
+        }
+      }
+    }
+    updated.push_back(&cotanLaplacianQ);
+  }
 
-      double cotValue = dot(vecR, vecL) / norm(cross(vecR, vecL));
-      cotSum += cotValue / 2;
+  if (vertexLumpedMassMatrixQ.computed && vertexDualAreasQ.computed && vertexIndicesQ.computed) {
+    for (Vertex v : faceVertices) {
+      size_t iV = vertexIndices[v];
+      vertexLumpedMassMatrix.coeffRef(iV, iV) = vertexDualAreas[v];
     }
+    updated.push_back(&vertexLumpedMassMatrixQ);
+  }
 
-    edgeCotanWeights[e] = cotSum;
+  // Anything else is recomputed from scratch, as in refreshQuantities()
+  for (DependentQuantity* q : quantities) {
+    if (std::find(updated.begin(), updated.end(), q) == updated.end()) {
+      q->computed = false;
+    }
+  }
+  for (DependentQuantity* q : quantities) {
+    q->ensureHaveIfRequired();
   }
 }
 
-
 } // namespace surface
 } // namespace geometrycentral
@@ -3,6 +3,48 @@
 
 namespace geometrycentral {
 namespace surface {
+
+// Helpers for below
+namespace {
+
+// Check that a vertex index is in range, and mark it as used
+inline void markVertexUsed(size_t i, std::vector<char>& vertexUsed) {
+  GC_SAFETY_ASSERT(i < vertexUsed.size(), "polygon list has index " + std::to_string(i) + " >= num vertices " +
+                                               std::to_string(vertexUsed.size()));
+  vertexUsed[i] = true;
+}
+
+// Compute new indices for the used vertices, and gather their positions
+std::vector<size_t> compressVertexIndices(const std::vector<char>& vertexUsed,
+                                          const std::vector<Vector3>& vertexPositions,
+                                          std::vector<Vector3>& newVertexPositions) {
+  size_t nV = vertexPositions.size();
+  std::vector<size_t> newInd(nV, INVALID_IND);
+  newVertexPositions.resize(nV);
+  size_t nNewV = 0;
+  for (size_t iOldV = 0; iOldV < nV; iOldV++) {
+    if (!vertexUsed[iOldV]) continue;
+    size_t iNewV = nNewV++;
+    newInd[iOldV] = iNewV;
+    newVertexPositions[iNewV] = vertexPositions[iOldV];
+  }
+  return newInd;
+}
+
+// Build the geometry object for a newly-constructed mesh
+std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+attachGeometry(std::unique_ptr<HalfedgeMesh> mesh, const std::vector<Vector3>& vertexPositions) {
+  std::unique_ptr<VertexPositionGeometry> geometry(new VertexPositionGeometry(*mesh));
+  for (Vertex v : mesh->vertices()) {
+    // Use the low-level indexers here since we're constructing
+    (*geometry).inputVertexPositions[v] = vertexPositions[v.getIndex()];
+  }
+
+  return std::make_tuple(std::move(mesh), std::move(geometry));
+}
+
+} // namespace
+
 std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
 makeHalfedgeAndGeometry(const std::vector<std::vector<size_t>>& polygons, const std::vector<Vector3> vertexPositions,
                         bool compressIndices, bool verbose) {
@@ -10,27 +52,16 @@ makeHalfedgeAndGeometry(const std::vector<std::vector<size_t>>& polygons, const
   if (compressIndices) {
 
     // Check which indices are used
-    size_t nV = vertexPositions.size();
-    std::vector<char> vertexUsed(nV, false);
+    std::vector<char> vertexUsed(vertexPositions.size(), false);
     for (auto poly : polygons) {
       for (auto i : poly) {
-        GC_SAFETY_ASSERT(i < nV,
-                         "polygon list has index " + std::to_string(i) + " >= num vertices " + std::to_string(nV));
-        vertexUsed[i] = true;
+        markVertexUsed(i, vertexUsed);
       }
     }
 
-
     // Re-index
-    std::vector<size_t> newInd(nV, INVALID_IND);
-    std::vector<Vector3> newVertexPositions(nV);
-    size_t nNewV = 0;
-    for (size_t iOldV = 0; iOldV < nV; iOldV++) {
-      if (!vertexUsed[iOldV]) continue;
-      size_t iNewV = nNewV++;
-      newInd[iOldV] = iNewV;
-      newVertexPositions[iNewV] = vertexPositions[iOldV];
-    }
+    std::vector<Vector3> newVertexPositions;
+    std::vector<size_t> newInd = compressVertexIndices(vertexUsed, vertexPositions, newVertexPositions);
 
     // Translate the polygon listing
     std::vector<std::vector<size_t>> newPolygons = polygons;
@@ -40,30 +71,93 @@ makeHalfedgeAndGeometry(const std::vector<std::vector<size_t>>& polygons, const
       }
     }
 
-
-    // Construct
     std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(newPolygons, verbose));
-    std::unique_ptr<VertexPositionGeometry> geometry(new VertexPositionGeometry(*mesh));
-    for (Vertex v : mesh->vertices()) {
-      // Use the low-level indexers here since we're constructing
-      (*geometry).inputVertexPositions[v] = newVertexPositions[v.getIndex()];
+    return attachGeometry(std::move(mesh), newVertexPositions);
+  } else {
+    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(polygons, verbose));
+    return attachGeometry(std::move(mesh), vertexPositions);
+  }
+}
+
+template <typename T>
+std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<T>& faceIndices, const std::vector<size_t>& faceStart,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices, bool verbose) {
+
+  if (compressIndices) {
+
+    // Check which indices are used
+    std::vector<char> vertexUsed(vertexPositions.size(), false);
+    for (T i : faceIndices) {
+      markVertexUsed(i, vertexUsed);
     }
 
-    return std::make_tuple(std::move(mesh), std::move(geometry));
+    // Re-index
+    std::vector<Vector3> newVertexPositions;
+    std::vector<size_t> newInd = compressVertexIndices(vertexUsed, vertexPositions, newVertexPositions);
+
+    // Translate the face listing
+    std::vector<T> newFaceIndices(faceIndices.size());
+    for (size_t iC = 0; iC < faceIndices.size(); iC++) {
+      newFaceIndices[iC] = newInd[faceIndices[iC]];
+    }
 
+    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(newFaceIndices, faceStart, verbose));
+    return attachGeometry(std::move(mesh), newVertexPositions);
   } else {
+    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(faceIndices, faceStart, verbose));
+    return attachGeometry(std::move(mesh), vertexPositions);
+  }
+}
 
-    // Construct
-    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(polygons, verbose));
-    std::unique_ptr<VertexPositionGeometry> geometry(new VertexPositionGeometry(*mesh));
-    for (Vertex v : mesh->vertices()) {
-      // Use the low-level indexers here since we're constructing
-      (*geometry).inputVertexPositions[v] = vertexPositions[v.getIndex()];
+template <typename T>
+std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<std::array<T, 3>>& triangles, const std::vector<Vector3>& vertexPositions,
+                        bool compressIndices, bool verbose) {
+
+  if (compressIndices) {
+
+    // Check which indices are used
+    std::vector<char> vertexUsed(vertexPositions.size(), false);
+    for (const std::array<T, 3>& tri : triangles) {
+      for (T i : tri) {
+        markVertexUsed(i, vertexUsed);
+      }
     }
 
-    return std::make_tuple(std::move(mesh), std::move(geometry));
+    // Re-index
+    std::vector<Vector3> newVertexPositions;
+    std::vector<size_t> newInd = compressVertexIndices(vertexUsed, vertexPositions, newVertexPositions);
+
+    // Translate the triangle listing
+    std::vector<std::array<T, 3>> newTriangles(triangles.size());
+    for (size_t iF = 0; iF < triangles.size(); iF++) {
+      for (size_t j = 0; j < 3; j++) {
+        newTriangles[iF][j] = newInd[triangles[iF][j]];
+      }
+    }
+
+    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(newTriangles, verbose));
+    return attachGeometry(std::move(mesh), newVertexPositions);
+  } else {
+    std::unique_ptr<HalfedgeMesh> mesh(new HalfedgeMesh(triangles, verbose));
+    return attachGeometry(std::move(mesh), vertexPositions);
   }
 }
 
+// Explicit instantiations
+template std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<size_t>& faceIndices, const std::vector<size_t>& faceStart,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices, bool verbose);
+template std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<uint32_t>& faceIndices, const std::vector<size_t>& faceStart,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices, bool verbose);
+template std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<std::array<size_t, 3>>& triangles,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices, bool verbose);
+template std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>>
+makeHalfedgeAndGeometry(const std::vector<std::array<uint32_t, 3>>& triangles,
+                        const std::vector<Vector3>& vertexPositions, bool compressIndices, bool verbose);
+
 } // namespace surface
 } // namespace geometrycentral
@@ -5,10 +5,15 @@
 #include "geometrycentral/utilities/timing.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <limits>
 #include <map>
 #include <set>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -28,13 +33,14 @@ HalfedgeMesh::HalfedgeMesh() {}
 // Helpers for below
 namespace {
 
-// Find an element in a sorted list
-size_t halfedgeLookup(const std::vector<size_t>& compressedList, size_t target, size_t start, size_t end) {
+// Find the corner of the outgoing halfedge with the given tip vertex in a sorted list of (tip, corner) pairs
+size_t halfedgeLookup(const std::vector<std::pair<size_t, size_t>>& compressedList, size_t target, size_t start,
+                      size_t end) {
   // Linear search is fast for small searches
   if (end - start < 20) {
     for (size_t i = start; i < end; i++) {
-      if (compressedList[i] == target) {
-        return i;
+      if (compressedList[i].first == target) {
+        return compressedList[i].second;
       }
     }
     return std::numeric_limits<size_t>::max();
@@ -42,174 +48,377 @@ size_t halfedgeLookup(const std::vector<size_t>& compressedList, size_t target,
   // ...but we don't want to degrade to O(N^2) for really high valence vertices,
   // so fall back to a binary search
   else {
-    auto loc = std::lower_bound(compressedList.begin() + start, compressedList.begin() + end, target);
+    auto loc = std::lower_bound(compressedList.begin() + start, compressedList.begin() + end, target,
+                                [](const std::pair<size_t, size_t>& entry, size_t val) { return entry.first < val; });
 
-    if (loc != (compressedList.begin() + end) && (target == *loc)) {
-      return loc - compressedList.begin();
+    if (loc != (compressedList.begin() + end) && (target == loc->first)) {
+      return loc->second;
     } else {
       return std::numeric_limits<size_t>::max();
     }
   }
 }
 
+// Split [0,N) in to nChunks contiguous chunks and call func(iChunk, start, end) on each, one thread per chunk. With a
+// single chunk, just calls func on this thread. Exceptions thrown in a chunk are rethrown here once all chunks finish
+// (from the lowest-index chunk which threw, if there are several).
+template <typename F>
+void runChunks(size_t nChunks, size_t N, F&& func) {
+  if (nChunks == 1) {
+    func(0, 0, N);
+    return;
+  }
+
+  std::vector<std::exception_ptr> chunkErrors(nChunks);
+  std::vector<std::thread> threads;
+  for (size_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    size_t start = N * iChunk / nChunks;
+    size_t end = N * (iChunk + 1) / nChunks;
+    threads.emplace_back([&func, &chunkErrors, iChunk, start, end]() {
+      try {
+        func(iChunk, start, end);
+      } catch (...) {
+        chunkErrors[iChunk] = std::current_exception();
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (std::exception_ptr& e : chunkErrors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+// Uniform access to the various face list formats accepted by the constructors
+struct PolygonListFaces {
+  const std::vector<std::vector<size_t>>& polygons;
+  size_t nFaces() const { return polygons.size(); }
+  size_t degree(size_t iF) const { return polygons[iF].size(); }
+  size_t vertex(size_t iF, size_t iFaceV) const { return polygons[iF][iFaceV]; }
+};
+
+template <typename T>
+struct FlatFaces {
+  const std::vector<T>& faceIndices;
+  const std::vector<size_t>& faceStart;
+  size_t nFaces() const { return faceStart.size() - 1; }
+  size_t degree(size_t iF) const { return faceStart[iF + 1] - faceStart[iF]; }
+  size_t vertex(size_t iF, size_t iFaceV) const { return faceIndices[faceStart[iF] + iFaceV]; }
+};
+
+template <typename T, size_t D>
+struct FixedDegreeFaces {
+  const std::vector<std::array<T, D>>& faces;
+  size_t nFaces() const { return faces.size(); }
+  size_t degree(size_t iF) const { return D; }
+  size_t vertex(size_t iF, size_t iFaceV) const { return faces[iF][iFaceV]; }
+};
+
+// Check that newToOld is a permutation of [0,nFill), and extend it with the identity up to the buffer capacity
+std::vector<size_t> extendPermutation(const std::vector<size_t>& newToOld, size_t nFill, size_t capacity,
+                                      std::string elementName) {
+  GC_SAFETY_ASSERT(newToOld.size() == nFill, elementName + " permutation has wrong size");
+  std::vector<size_t> perm(capacity);
+  std::vector<char> seen(nFill, false);
+  for (size_t i = 0; i < nFill; i++) {
+    size_t iOld = newToOld[i];
+    GC_SAFETY_ASSERT(iOld < nFill && !seen[iOld], elementName + " permutation is not a permutation");
+    seen[iOld] = true;
+    perm[i] = iOld;
+  }
+  for (size_t i = nFill; i < capacity; i++) {
+    perm[i] = i;
+  }
+  return perm;
+}
+
+std::vector<size_t> invertPermutation(const std::vector<size_t>& perm) {
+  std::vector<size_t> inv(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    inv[perm[i]] = i;
+  }
+  return inv;
+}
+
+// Permutation of a buffer which moves the live elements to the front (in their current order), followed by the dead
+// elements, followed by the rest of the buffer
+template <typename F>
+std::vector<size_t> compressingPermutation(size_t nFill, size_t capacity, F isDead) {
+  std::vector<size_t> perm;
+  perm.reserve(capacity);
+  for (size_t i = 0; i < nFill; i++) {
+    if (!isDead(i)) perm.push_back(i);
+  }
+  for (size_t i = 0; i < nFill; i++) {
+    if (isDead(i)) perm.push_back(i);
+  }
+  for (size_t i = nFill; i < capacity; i++) {
+    perm.push_back(i);
+  }
+  return perm;
+}
+
 } // namespace
 
-HalfedgeMesh::HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, bool verbose) {
+template <typename F>
+void HalfedgeMesh::constructFromFaces(const F& faces, bool verbose, size_t nThreads) {
 
   // Assumes that the input index set is dense. This sometimes isn't true of (eg) obj files floating around the
   // internet, so consider removing unused vertices first when reading from foreign sources.
 
+  // Construction proceeds in a sequence of passes over contiguous chunks of faces, vertices, or halfedges, each of
+  // which can run on its own thread. Every pass is written so that the result does not depend on the number of threads.
+
   START_TIMING(construction)
 
+  if (nThreads == 0) {
+    nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // Each pass starts its own threads, which only pays off when there is plenty of work for each of them. Small meshes
+  // are built on this thread alone.
+  const size_t minFacesPerThread = 10000;
+  nThreads = std::max<size_t>(std::min<size_t>(nThreads, faces.nFaces() / minFacesPerThread), 1);
+
   // Check input list and measure some element counts
-  nFacesCount = polygons.size();
-  nVerticesCount = 0;
-  for (const std::vector<size_t>& poly : polygons) {
-    GC_SAFETY_ASSERT(poly.size() >= 3, "faces must have degree >= 3");
-    for (auto i : poly) {
-      nVerticesCount = std::max(nVerticesCount, i);
+  // (corners are numbered in the order they appear in the face list, each is the tail of one interior halfedge)
+  nFacesCount = faces.nFaces();
+  std::vector<size_t> chunkCornerStart(nThreads + 1, 0);
+  std::vector<size_t> chunkMaxVertex(nThreads, 0);
+  runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+    for (size_t iFace = start; iFace < end; iFace++) {
+      size_t faceDegree = faces.degree(iFace);
+      GC_SAFETY_ASSERT(faceDegree >= 3, "faces must have degree >= 3");
+      for (size_t iFaceV = 0; iFaceV < faceDegree; iFaceV++) {
+        chunkMaxVertex[iChunk] = std::max(chunkMaxVertex[iChunk], faces.vertex(iFace, iFaceV));
+      }
+      chunkCornerStart[iChunk + 1] += faceDegree;
     }
+  });
+  nVerticesCount = 0;
+  for (size_t iChunk = 0; iChunk < nThreads; iChunk++) {
+    nVerticesCount = std::max(nVerticesCount, chunkMaxVertex[iChunk]);
+    chunkCornerStart[iChunk + 1] += chunkCornerStart[iChunk];
   }
   nVerticesCount++; // 0-based means count is max+1
+  size_t nFaceCorners = chunkCornerStart[nThreads];
 
   // Pre-allocate face and vertex arrays
-  vHalfedge = std::vector<size_t>(nVerticesCount, INVALID_IND);
-  fHalfedge = std::vector<size_t>(nFacesCount, INVALID_IND);
+  vHalfedge = IndexVector(nVerticesCount, INVALID_IND);
+  fHalfedge = IndexVector(nFacesCount, INVALID_IND);
 
-  // Track halfedges which have already been created
-  // TODO replace with compressed list for performance
-  std::unordered_map<std::tuple<size_t, size_t>, size_t> createdHalfedges;
-  auto createdHeLookup = [&](std::tuple<size_t, size_t> key) -> size_t& {
-    if (createdHalfedges.find(key) == createdHalfedges.end()) {
-      createdHalfedges[key] = INVALID_IND;
-    }
-    return createdHalfedges[key];
-  };
+  // Walking the corners in order, an edge is created the first time either of its halfedges is seen, and the halfedge
+  // seen first gets the even index.
+  std::vector<size_t> cornerHalfedge(nFaceCorners);
+  {
+    // Build a compressed list of the outgoing halfedges at each vertex, as (tip, corner) pairs sorted by tip. Twins
+    // are then found by a lookup in the tip vertex's list, rather than hashing every halfedge.
+    std::vector<size_t> vertexOutStart(nVerticesCount + 1);
+    std::vector<std::pair<size_t, size_t>> vertexOut(nFaceCorners);
+    {
+      std::vector<std::atomic<size_t>> vertexOutFill(nVerticesCount + 1); // value-initialized to 0
+      runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+        for (size_t iFace = start; iFace < end; iFace++) {
+          for (size_t iFaceV = 0; iFaceV < faces.degree(iFace); iFaceV++) {
+            vertexOutFill[faces.vertex(iFace, iFaceV) + 1].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      });
+      vertexOutStart[0] = 0;
+      for (size_t iV = 0; iV < nVerticesCount; iV++) {
+        vertexOutStart[iV + 1] = vertexOutStart[iV] + vertexOutFill[iV + 1].load(std::memory_order_relaxed);
+        vertexOutFill[iV].store(vertexOutStart[iV], std::memory_order_relaxed);
+      }
 
-  // Walk the faces, creating halfedges and hooking up pointers
-  for (size_t iFace = 0; iFace < nFacesCount; iFace++) {
-    const std::vector<size_t>& poly = polygons[iFace];
-
-    // Walk around this face
-    size_t faceDegree = poly.size();
-    size_t prevHeInd = INVALID_IND;
-    size_t firstHeInd = INVALID_IND;
-    for (size_t iFaceHe = 0; iFaceHe < faceDegree; iFaceHe++) {
-
-      size_t indTail = poly[iFaceHe];
-      size_t indTip = poly[(iFaceHe + 1) % faceDegree];
-
-      // Get an index for this halfedge
-      std::tuple<size_t, size_t> heKey{indTail, indTip};
-      std::tuple<size_t, size_t> heTwinKey{indTip, indTail};
-      size_t& halfedgeInd = createdHeLookup(heKey);
-
-      // Some sanity checks
-      GC_SAFETY_ASSERT(indTail != indTip,
-                       "self-edge in face list " + std::to_string(indTail) + " -- " + std::to_string(indTip));
-      GC_SAFETY_ASSERT(halfedgeInd == INVALID_IND,
-                       "duplicate edge in list " + std::to_string(indTail) + " -- " + std::to_string(indTip));
-
-      // Find the twin to check if the element is already created
-      size_t twinInd = createdHeLookup(heTwinKey);
-      if (twinInd == INVALID_IND) {
-        // If we haven't seen the twin yet either, create a new edge
-        // TODO use createHalfedge() or something here?
-        halfedgeInd = nHalfedgesCount;
-        nHalfedgesCount += 2;
-
-        // Grow arrays to make space
-        heNext.push_back(INVALID_IND);
-        heNext.push_back(INVALID_IND);
-        heVertex.push_back(indTail);
-        heVertex.push_back(indTip);
-        heFace.push_back(INVALID_IND);
-        heFace.push_back(INVALID_IND);
-      } else {
-        // If the twin has already been created, we have an index for the halfedge
-        halfedgeInd = heTwin(twinInd);
+      runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+        size_t iCorner = chunkCornerStart[iChunk];
+        for (size_t iFace = start; iFace < end; iFace++) {
+          size_t faceDegree = faces.degree(iFace);
+          for (size_t iFaceHe = 0; iFaceHe < faceDegree; iFaceHe++) {
+            size_t indTail = faces.vertex(iFace, iFaceHe);
+            size_t indTip = faces.vertex(iFace, (iFaceHe + 1) % faceDegree);
+            GC_SAFETY_ASSERT(indTail != indTip,
+                             "self-edge in face list " + std::to_string(indTail) + " -- " + std::to_string(indTip));
+            size_t iOut = vertexOutFill[indTail].fetch_add(1, std::memory_order_relaxed);
+            vertexOut[iOut] = std::make_pair(indTip, iCorner);
+            iCorner++;
+          }
+        }
+      });
+    }
+
+    // Sort each vertex's list by tip (these lists are short, so this is cheap). This also puts the entries in a
+    // deterministic order, regardless of the order the fill above happened in.
+    // vHalfedge temporarily holds the last corner in each vertex's list, which is the last one in face order.
+    runChunks(nThreads, nVerticesCount, [&](size_t iChunk, size_t start, size_t end) {
+      for (size_t iV = start; iV < end; iV++) {
+        std::sort(vertexOut.begin() + vertexOutStart[iV], vertexOut.begin() + vertexOutStart[iV + 1]);
+        for (size_t i = vertexOutStart[iV]; i < vertexOutStart[iV + 1]; i++) {
+          GC_SAFETY_ASSERT(i == vertexOutStart[iV] || vertexOut[i].first != vertexOut[i - 1].first,
+                           "duplicate edge in list " + std::to_string(iV) + " -- " +
+                               std::to_string(vertexOut[i].first));
+          if (vHalfedge[iV] == INVALID_IND || vertexOut[i].second > vHalfedge[iV]) {
+            vHalfedge[iV] = vertexOut[i].second;
+          }
+        }
       }
+    });
+
+    // Find the twin of each corner. A corner creates a new edge if its twin comes later in the face list, or does
+    // not exist (INVALID_IND is never less than a corner index).
+    std::vector<char> cornerCreatesEdge(nFaceCorners);
+    std::vector<size_t> chunkEdgeStart(nThreads + 1, 0);
+    runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+      size_t iCorner = chunkCornerStart[iChunk];
+      for (size_t iFace = start; iFace < end; iFace++) {
+        size_t faceDegree = faces.degree(iFace);
+        for (size_t iFaceHe = 0; iFaceHe < faceDegree; iFaceHe++) {
+          size_t indTail = faces.vertex(iFace, iFaceHe);
+          size_t indTip = faces.vertex(iFace, (iFaceHe + 1) % faceDegree);
+          size_t twinCorner = halfedgeLookup(vertexOut, indTail, vertexOutStart[indTip], vertexOutStart[indTip + 1]);
+          cornerHalfedge[iCorner] = twinCorner;
+          cornerCreatesEdge[iCorner] = twinCorner > iCorner;
+          if (cornerCreatesEdge[iCorner]) {
+            chunkEdgeStart[iChunk + 1]++;
+          }
+          iCorner++;
+        }
+      }
+    });
+    for (size_t iChunk = 0; iChunk < nThreads; iChunk++) {
+      chunkEdgeStart[iChunk + 1] += chunkEdgeStart[iChunk];
+    }
+    nHalfedgesCount = 2 * chunkEdgeStart[nThreads];
+
+    // Number the new edges, and give the twin corner (if any) the odd halfedge. Each twin corner is written by
+    // exactly one edge-creating corner, and is never read in this pass.
+    runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+      size_t iEdge = chunkEdgeStart[iChunk];
+      for (size_t iCorner = chunkCornerStart[iChunk]; iCorner < chunkCornerStart[iChunk + 1]; iCorner++) {
+        if (!cornerCreatesEdge[iCorner]) continue;
+        size_t twinCorner = cornerHalfedge[iCorner];
+        cornerHalfedge[iCorner] = eHalfedge(iEdge);
+        if (twinCorner != INVALID_IND) {
+          cornerHalfedge[twinCorner] = heTwin(eHalfedge(iEdge));
+        }
+        iEdge++;
+      }
+    });
+  }
+
+  // Allocate halfedge arrays. Exterior halfedges keep an invalid next and face until boundary loops are resolved below.
+  heNext = IndexVector(nHalfedgesCount, INVALID_IND);
+  heVertex = IndexVector(nHalfedgesCount, INVALID_IND);
+  heFace = IndexVector(nHalfedgesCount, INVALID_IND);
+
+  // Walk the faces, hooking up pointers
+  runChunks(nThreads, nFacesCount, [&](size_t iChunk, size_t start, size_t end) {
+    size_t iFaceStart = chunkCornerStart[iChunk];
+    for (size_t iFace = start; iFace < end; iFace++) {
+      size_t faceDegree = faces.degree(iFace);
+      for (size_t iFaceHe = 0; iFaceHe < faceDegree; iFaceHe++) {
+        size_t halfedgeInd = cornerHalfedge[iFaceStart + iFaceHe];
+        heNext[halfedgeInd] = cornerHalfedge[iFaceStart + (iFaceHe + 1) % faceDegree];
+        heVertex[halfedgeInd] = faces.vertex(iFace, iFaceHe);
+        heFace[halfedgeInd] = iFace;
+      }
+      fHalfedge[iFace] = cornerHalfedge[iFaceStart];
+      iFaceStart += faceDegree;
+    }
+  });
 
-      // Hook up a bunch of pointers
-      heFace[halfedgeInd] = iFace;
-      vHalfedge[indTail] = halfedgeInd;
-      if (iFaceHe == 0) {
-        fHalfedge[iFace] = halfedgeInd;
-        firstHeInd = halfedgeInd;
-      } else {
-        heNext[prevHeInd] = halfedgeInd;
+  // Each vertex points to the halfedge from the last corner it appears in
+  runChunks(nThreads, nVerticesCount, [&](size_t iChunk, size_t start, size_t end) {
+    for (size_t iV = start; iV < end; iV++) {
+      if (vHalfedge[iV] != INVALID_IND) {
+        vHalfedge[iV] = cornerHalfedge[vHalfedge[iV]];
       }
-      prevHeInd = halfedgeInd;
     }
+  });
+  cornerHalfedge = std::vector<size_t>();
 
-    heNext[prevHeInd] = firstHeInd; // hook up the first next() pointer, which we missed in the loop above
-  }
+  // Exterior halfedges point from the tip to the tail of their interior twin
+  runChunks(nThreads, nHalfedgesCount, [&](size_t iChunk, size_t start, size_t end) {
+    for (size_t iHe = start; iHe < end; iHe++) {
+      if (heNext[iHe] == INVALID_IND) {
+        heVertex[iHe] = heVertex[heNext[heTwin(iHe)]];
+      }
+    }
+  });
 
   // Ensure that each boundary neighborhood is either a disk or a half-disk. Harder to diagnose if we wait until the
-  // boundary walk below.
-#ifndef NGC_SAFTEY_CHECKS
+  // boundary walk below. On several threads, that walk also relies on this for exterior halfedges to be written by only
+  // one thread, so there the check is made even when safety checks are disabled.
+#ifdef NGC_SAFTEY_CHECKS
+  if (nThreads > 1)
+#endif
   {
-    std::vector<char> vertexOnBoundary(nVerticesCount, false);
-    for (size_t iHe = 0; iHe < nHalfedgesCount; iHe++) {
-      if (heNext[iHe] == INVALID_IND) {
-        size_t v = heVertex[iHe];
-        GC_SAFETY_ASSERT(!vertexOnBoundary[v],
-                         "vertex " + std::to_string(v) + " appears in more than one boundary loop");
-        vertexOnBoundary[v] = true;
+    std::vector<std::atomic<char>> vertexOnBoundary(nVerticesCount); // value-initialized to false
+    runChunks(nThreads, nHalfedgesCount, [&](size_t iChunk, size_t start, size_t end) {
+      for (size_t iHe = start; iHe < end; iHe++) {
+        if (heNext[iHe] == INVALID_IND) {
+          size_t v = heVertex[iHe];
+          if (vertexOnBoundary[v].exchange(true, std::memory_order_relaxed)) {
+            throw std::runtime_error("vertex " + std::to_string(v) + " appears in more than one boundary loop");
+          }
+        }
       }
-    }
+    });
   }
-#endif
 
   // == Resolve boundary loops
-  nInteriorHalfedgesCount = nHalfedgesCount; // will decrement as we find exterior
-  for (size_t iHe = 0; iHe < nHalfedgesCount; iHe++) {
-
-    // If the face pointer is invalid, the halfedge must be along an unresolved boundary loop
-    if (heFace[iHe] != INVALID_IND) continue;
 
-    // Create the new boundary loop
-    size_t boundaryLoopInd = nFacesCount + nBoundaryLoopsCount;
-    fHalfedge.push_back(iHe);
-    nBoundaryLoopsCount++;
+  // For each exterior halfedge, orbit around its tail to find the exterior halfedge which comes before it in its
+  // boundary loop, and point that halfedge's next here. Since each boundary vertex is on only one boundary loop
+  // (checked above), every exterior halfedge is written by exactly one other.
+  std::vector<std::vector<size_t>> chunkExteriorHalfedges(nThreads);
+  runChunks(nThreads, nHalfedgesCount, [&](size_t iChunk, size_t start, size_t end) {
+    for (size_t iHe = start; iHe < end; iHe++) {
+      if (heFace[iHe] != INVALID_IND) continue;
+      chunkExteriorHalfedges[iChunk].push_back(iHe);
 
-    // = Walk around the loop (CW)
-    size_t currHe = iHe;
-    size_t prevHe = INVALID_IND;
-    size_t loopCount = 0;
-    do {
-
-      // The boundary loop is the face for these halfedges
-      heFace[currHe] = boundaryLoopInd;
-
-      // currHe.twin() is a boundary interior halfedge, this is a good time to enforce that v.halfedge() is always the
+      // heTwin(iHe) is a boundary interior halfedge, this is a good time to enforce that v.halfedge() is always the
       // boundary interior halfedge for a boundary vertex.
-      size_t currHeT = heTwin(currHe);
-      vHalfedge[heVertex[currHeT]] = currHeT;
-
-      // This isn't an interior halfedge.
-      nInteriorHalfedgesCount--;
-
-      // Advance to the next halfedge along the boundary
-      prevHe = currHe;
-      currHe = heTwin(heNext[heTwin(currHe)]);
-      size_t loopCountInnter = 0;
-      while (heFace[currHe] != INVALID_IND) {
-        if (currHe == iHe) break;
-        currHe = heTwin(heNext[currHe]);
-        loopCountInnter++;
-        GC_SAFETY_ASSERT(loopCountInnter < nHalfedgesCount, "boundary infinite loop orbit");
+      size_t iHeT = heTwin(iHe);
+      vHalfedge[heVertex[iHeT]] = iHeT;
+
+      size_t prevHe = heTwin(heNext[iHeT]);
+      size_t loopCount = 0;
+      while (heFace[prevHe] != INVALID_IND) {
+        prevHe = heTwin(heNext[prevHe]);
+        loopCount++;
+        GC_SAFETY_ASSERT(loopCount < nHalfedgesCount, "boundary infinite loop orbit");
       }
+      heNext[prevHe] = iHe;
+    }
+  });
+
+  // Number the boundary loops in order of their lowest-index halfedge
+  nInteriorHalfedgesCount = nHalfedgesCount;
+  for (const std::vector<size_t>& exteriorHalfedges : chunkExteriorHalfedges) {
+    nInteriorHalfedgesCount -= exteriorHalfedges.size();
+    for (size_t iHe : exteriorHalfedges) {
 
-      // Set the next pointer around the boundary loop
-      heNext[currHe] = prevHe;
+      // If the face pointer is invalid, the halfedge must be along an unresolved boundary loop
+      if (heFace[iHe] != INVALID_IND) continue;
 
-      // Make sure this loop doesn't infinite-loop. Certainly won't happen for proper input, but might happen for bogus
-      // input. I don't _think_ it can happen, but there might be some non-manifold input which manfests failure via an
-      // infinte loop here, and such a loop is an inconvenient failure mode.
-      loopCount++;
-      GC_SAFETY_ASSERT(loopCount < nHalfedgesCount, "boundary infinite loop");
-    } while (currHe != iHe);
+      // Create the new boundary loop
+      size_t boundaryLoopInd = nFacesCount + nBoundaryLoopsCount;
+      fHalfedge.push_back(iHe);
+      nBoundaryLoopsCount++;
+
+      // Walk around the loop. Make sure this loop doesn't infinite-loop. Certainly won't happen for proper input, but
+      // might happen for bogus input which wasn't caught above, and such a loop is an inconvenient failure mode.
+      size_t currHe = iHe;
+      size_t loopCount = 0;
+      do {
+        heFace[currHe] = boundaryLoopInd;
+        currHe = heNext[currHe];
+        loopCount++;
+        GC_SAFETY_ASSERT(loopCount < nHalfedgesCount, "boundary infinite loop");
+      } while (currHe != iHe);
+    }
   }
 
   // SOMEDAY: could shrink_to_fit() std::vectors here, at the cost of a copy. What's preferable?
@@ -226,26 +435,32 @@ HalfedgeMesh::HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, boo
 
 #ifndef NGC_SAFTEY_CHECKS
   { // Check that the input was manifold in the sense that each vertex has a single connected loop of faces around it.
+    // Each orbit only touches halfedges whose tail is that vertex, so vertices can be checked independently.
     std::vector<char> halfedgeSeen(nHalfedgesCount, false);
-    for (size_t iV = 0; iV < nVerticesCount; iV++) {
+    runChunks(nThreads, nVerticesCount, [&](size_t iChunk, size_t start, size_t end) {
+      for (size_t iV = start; iV < end; iV++) {
 
-      // For each vertex, orbit around the outgoing halfedges. This _should_ touch every halfedge.
-      size_t currHe = vHalfedge[iV];
-      size_t firstHe = currHe;
-      do {
+        // For each vertex, orbit around the outgoing halfedges. This _should_ touch every halfedge.
+        size_t currHe = vHalfedge[iV];
+        size_t firstHe = currHe;
+        do {
 
-        GC_SAFETY_ASSERT(!halfedgeSeen[currHe], "somehow encountered outgoing halfedge before orbiting v");
-        halfedgeSeen[currHe] = true;
+          GC_SAFETY_ASSERT(!halfedgeSeen[currHe], "somehow encountered outgoing halfedge before orbiting v");
+          halfedgeSeen[currHe] = true;
 
-        currHe = heNext[heTwin(currHe)];
-      } while (currHe != firstHe);
-    }
+          currHe = heNext[heTwin(currHe)];
+        } while (currHe != firstHe);
+      }
+    });
 
     // Verify that we actually did touch every halfedge.
-    for (size_t iHe = 0; iHe < nHalfedgesCount; iHe++) {
-      GC_SAFETY_ASSERT(halfedgeSeen[iHe], "mesh not manifold. Vertex " + std::to_string(heVertex[iHe]) +
-                                              " has disconnected neighborhoods incident (imagine an hourglass)");
-    }
+    runChunks(nThreads, nHalfedgesCount, [&](size_t iChunk, size_t start, size_t end) {
+      for (size_t iHe = start; iHe < end; iHe++) {
+        GC_SAFETY_ASSERT(halfedgeSeen[iHe], "mesh not manifold. Vertex " +
+                                                std::to_string(static_cast<size_t>(heVertex[iHe])) +
+                                                " has disconnected neighborhoods incident (imagine an hourglass)");
+      }
+    });
   }
 #endif
 
@@ -257,11 +472,46 @@ HalfedgeMesh::HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, boo
   }
 }
 
+HalfedgeMesh::HalfedgeMesh(const std::vector<std::vector<size_t>>& polygons, bool verbose, size_t nThreads) {
+  constructFromFaces(PolygonListFaces{polygons}, verbose, nThreads);
+}
+
+template <typename T>
+HalfedgeMesh::HalfedgeMesh(const std::vector<T>& faceIndices, const std::vector<size_t>& faceStart, bool verbose,
+                           size_t nThreads) {
+  GC_SAFETY_ASSERT(!faceStart.empty() && faceStart.front() == 0 && faceStart.back() == faceIndices.size(),
+                   "face start list must begin at 0 and end at the length of the face index list");
+  for (size_t iF = 0; iF + 1 < faceStart.size(); iF++) {
+    GC_SAFETY_ASSERT(faceStart[iF] <= faceStart[iF + 1], "face start list must be nondecreasing");
+  }
+  constructFromFaces(FlatFaces<T>{faceIndices, faceStart}, verbose, nThreads);
+}
+
+template <typename T>
+HalfedgeMesh::HalfedgeMesh(const std::vector<std::array<T, 3>>& triangles, bool verbose, size_t nThreads) {
+  constructFromFaces(FixedDegreeFaces<T, 3>{triangles}, verbose, nThreads);
+}
+
+// Explicit instantiations
+template HalfedgeMesh::HalfedgeMesh(const std::vector<size_t>& faceIndices, const std::vector<size_t>& faceStart,
+                                    bool verbose, size_t nThreads);
+template HalfedgeMesh::HalfedgeMesh(const std::vector<uint32_t>& faceIndices, const std::vector<size_t>& faceStart,
+                                    bool verbose, size_t nThreads);
+template HalfedgeMesh::HalfedgeMesh(const std::vector<std::array<size_t, 3>>& triangles, bool verbose, size_t nThreads);
+template HalfedgeMesh::HalfedgeMesh(const std::vector<std::array<uint32_t, 3>>& triangles, bool verbose,
+                                    size_t nThreads);
+
+
 
 HalfedgeMesh::~HalfedgeMesh() {
   for (auto& f : meshDeleteCallbackList) {
     f();
   }
+  vertexDynamicElements.detachAll();
+  halfedgeDynamicElements.detachAll();
+  edgeDynamicElements.detachAll();
+  faceDynamicElements.detachAll();
+  boundaryLoopDynamicElements.detachAll();
 }
 
 
@@ -427,6 +677,14 @@ std::unique_ptr<HalfedgeMesh> HalfedgeMesh::copy() const {
   newMesh->nFacesFillCount = nFacesFillCount;
   newMesh->nBoundaryLoopsFillCount = nBoundaryLoopsFillCount;
   newMesh->isCompressedFlag = isCompressedFlag;
+  newMesh->isCanonicalFlag = isCanonicalFlag;
+
+  // compaction state
+  newMesh->compactionMovesPerMutation = compactionMovesPerMutation;
+  newMesh->compactionTombstoneRatio = compactionTombstoneRatio;
+  newMesh->deadVertices = deadVertices;
+  newMesh->deadEdges = deadEdges;
+  newMesh->deadFaces = deadFaces;
 
 
   // Note: _don't_ copy callbacks lists! New mesh has new callbacks
@@ -450,6 +708,42 @@ std::vector<std::vector<size_t>> HalfedgeMesh::getFaceVertexList() {
   return result;
 }
 
+template <typename T>
+void HalfedgeMesh::getFaceVertexListFlat(std::vector<T>& faceIndices, std::vector<size_t>& faceStart) {
+  GC_SAFETY_ASSERT(nVertices() == 0 || nVertices() - 1 <= std::numeric_limits<T>::max(), "vertex indices do not fit in the index type");
+
+  faceIndices.clear();
+  faceIndices.reserve(nCorners());
+  faceStart.clear();
+  faceStart.reserve(nFaces() + 1);
+
+  VertexData<size_t> vInd = getVertexIndices();
+  faceStart.push_back(0);
+  for (Face f : faces()) {
+    for (Vertex v : f.adjacentVertices()) {
+      faceIndices.push_back(static_cast<T>(vInd[v]));
+    }
+    faceStart.push_back(faceIndices.size());
+  }
+}
+template void HalfedgeMesh::getFaceVertexListFlat(std::vector<size_t>& faceIndices, std::vector<size_t>& faceStart);
+template void HalfedgeMesh::getFaceVertexListFlat(std::vector<uint32_t>& faceIndices, std::vector<size_t>& faceStart);
+
+std::vector<std::array<size_t, 3>> HalfedgeMesh::getFaceVertexListTriangles() {
+
+  std::vector<std::array<size_t, 3>> result;
+  result.reserve(nFaces());
+
+  VertexData<size_t> vInd = getVertexIndices();
+  for (Face f : faces()) {
+    GC_SAFETY_ASSERT(f.isTriangle(), "mesh must be triangular");
+    Halfedge he = f.halfedge();
+    result.push_back({{vInd[he.vertex()], vInd[he.next().vertex()], vInd[he.next().next().vertex()]}});
+  }
+
+  return result;
+}
+
 
 // ==========================================================
 // ================        Mutation        ==================
@@ -457,6 +751,7 @@ std::vector<std::vector<size_t>> HalfedgeMesh::getFaceVertexList() {
 
 
 bool HalfedgeMesh::flip(Edge eFlip) {
+  checkNotFrozen();
   if (eFlip.isBoundary()) return false;
 
   // Get halfedges of first face
@@ -512,6 +807,7 @@ bool HalfedgeMesh::flip(Edge eFlip) {
 
 
 Halfedge HalfedgeMesh::insertVertexAlongEdge(Edge e) {
+  checkNotFrozen();
 
   // == Gather / create elements
   // Faces are identified as 'A', and 'B'
@@ -564,6 +860,7 @@ Halfedge HalfedgeMesh::insertVertexAlongEdge(Edge e) {
 
 
 Halfedge HalfedgeMesh::splitEdgeTriangular(Edge e) {
+  checkNotFrozen();
 
   // Check triangular assumption
   GC_SAFETY_ASSERT(e.halfedge().face().isTriangle(), "splitEdgeTriangular requires triangular faces");
@@ -589,6 +886,7 @@ Halfedge HalfedgeMesh::splitEdgeTriangular(Edge e) {
 
 
 Halfedge HalfedgeMesh::connectVertices(Halfedge heA, Halfedge heB) {
+  checkNotFrozen();
 
   // Gather a few values
   Halfedge heAPrev = heA.prevOrbitVertex();
@@ -722,6 +1020,7 @@ Halfedge HalfedgeMesh::connectVertices(Face faceIn, Vertex vAIn, Vertex vBIn) {
 */
 
 Vertex HalfedgeMesh::insertVertex(Face fIn) {
+  checkNotFrozen();
 
   // Create the new center vertex
   Vertex centerVert = getNewVertex();
@@ -795,6 +1094,122 @@ Vertex HalfedgeMesh::insertVertex(Face fIn) {
   return centerVert;
 }
 
+Vertex HalfedgeMesh::collapseEdge(Edge e) {
+  checkNotFrozen();
+
+  // === Gather some elements
+
+  if (e.isBoundary()) return Vertex();
+
+  // If there's a single boundary vertex, be sure we keep it
+  Halfedge heA0 = e.halfedge();
+  if (heA0.twin().vertex().isBoundary()) {
+    if (heA0.vertex().isBoundary()) return Vertex(); // would pinch the boundary
+    heA0 = heA0.twin();
+  }
+  Halfedge heA1 = heA0.next();
+  Halfedge heA2 = heA1.next();
+  Halfedge heB0 = heA0.twin();
+  Halfedge heB1 = heB0.next();
+  Halfedge heB2 = heB1.next();
+  if (heA2.next() != heA0 || heB2.next() != heB0) return Vertex(); // not triangles
+
+  Halfedge heA1T = heA1.twin();
+  Halfedge heB2T = heB2.twin();
+  Vertex vKeep = heA0.vertex();
+  Vertex vDiscard = heB0.vertex();
+  Vertex vA = heA2.vertex();
+  Vertex vB = heB2.vertex();
+
+  // === Check validity
+
+  // collapsing around a degree-2 vertex can be done, but this code does not handle that correctly
+  if (vKeep.degree() <= 2 || vDiscard.degree() <= 2 || vA == vB) return Vertex();
+
+  // (should be exactly two vertices, the opposite diamond vertices, in the intersection of the 1-rings)
+  std::unordered_set<Vertex> vKeepNeighbors;
+  for (Vertex vN : vKeep.adjacentVertices()) {
+    vKeepNeighbors.insert(vN);
+  }
+  size_t nShared = 0;
+  for (Vertex vN : vDiscard.adjacentVertices()) {
+    if (vKeepNeighbors.find(vN) != vKeepNeighbors.end()) {
+      nShared++;
+    }
+  }
+  if (nShared > 2) return Vertex();
+
+  // === Gather everything which will need updating, before we break things
+
+  std::vector<Halfedge> discardOutgoing;
+  for (Halfedge he : vDiscard.outgoingHalfedges()) {
+    discardOutgoing.push_back(he);
+  }
+
+  // The halfedges which come before the two outer halfedges that will be removed
+  auto prevHalfedge = [&](Halfedge he) {
+    for (Halfedge heOut : he.vertex().outgoingHalfedges()) {
+      if (heOut.twin().next() == he) return heOut.twin();
+    }
+    return Halfedge();
+  };
+  Halfedge heA1TPrev = prevHalfedge(heA1T);
+  Halfedge heB2TPrev = prevHalfedge(heB2T);
+
+  // === Update connectivity
+
+  // The two edges of each face merge. Since twins are implicit, the merged edge keeps the index of the one edge and
+  // its outer halfedge moves in to the slot of the inner halfedge on the other: heA1T takes the place of heA2, and
+  // heB2T takes the place of heB1.
+  size_t iHeA2 = heA2.getIndex();
+  size_t iHeB1 = heB1.getIndex();
+  auto newIndex = [&](Halfedge he) {
+    if (he == heA1T) return iHeA2;
+    if (he == heB2T) return iHeB1;
+    return he.getIndex();
+  };
+  size_t newNextA = newIndex(heA1T.next());
+  size_t newNextB = newIndex(heB2T.next());
+  heNext[iHeA2] = newNextA;
+  heVertex[iHeA2] = vA.getIndex();
+  heFace[iHeA2] = heA1T.face().getIndex();
+  heNext[iHeB1] = newNextB;
+  heVertex[iHeB1] = vKeep.getIndex();
+  heFace[iHeB1] = heB2T.face().getIndex();
+  heNext[newIndex(heA1TPrev)] = iHeA2;
+  heNext[newIndex(heB2TPrev)] = iHeB1;
+
+  for (Halfedge he : discardOutgoing) {
+    heVertex[he.getIndex()] = vKeep.getIndex();
+  }
+
+  // Fix faces which pointed at the moved halfedges (including boundary loops)
+  if (fHalfedge[heFace[heA1T.getIndex()]] == heA1T.getIndex()) fHalfedge[heFace[heA1T.getIndex()]] = iHeA2;
+  if (fHalfedge[heFace[heB2T.getIndex()]] == heB2T.getIndex()) fHalfedge[heFace[heB2T.getIndex()]] = iHeB1;
+
+  // Fix vertices. Only fix if needed, which ensures we don't mess up boundary vertices; the slots heA2 and heB1 are
+  // still outgoing from vA and vKeep, respectively.
+  if (vHalfedge[vKeep.getIndex()] == heA0.getIndex()) vHalfedge[vKeep.getIndex()] = iHeB1;
+  if (vHalfedge[vA.getIndex()] == heA1T.getIndex()) vHalfedge[vA.getIndex()] = iHeA2;
+  if (vHalfedge[vB.getIndex()] == heB2.getIndex()) vHalfedge[vB.getIndex()] = heB1.twin().getIndex();
+
+  // === Delete everything which needs to be deleted
+  deleteEdgeTriple(heA0);
+  deleteEdgeTriple(heA1);
+  deleteEdgeTriple(heB2);
+  deleteElement(heA0.face());
+  deleteElement(heB0.face());
+  deleteElement(vDiscard);
+
+  isCanonicalFlag = false;
+
+  // (compaction may move the vertex we're returning)
+  DynamicVertex vKeepDynamic(vKeep);
+  compactAfterMutation();
+
+  return vKeepDynamic.decay();
+}
+
 /*
 
 Vertex HalfedgeMesh::collapseEdge(Edge e) {
@@ -1017,6 +1432,7 @@ void HalfedgeMesh::ensureVertexHasBoundaryHalfedge(Vertex v) {
 }
 
 bool HalfedgeMesh::removeFaceAlongBoundary(Face f) {
+  checkNotFrozen();
 
   // Find the boundary halfedge
   Halfedge heBoundary;
@@ -1186,6 +1602,366 @@ std::vector<Face> HalfedgeMesh::triangulate(Face f) {
   return allFaces;
 }
 
+void HalfedgeMesh::beginBatch() {
+  checkNotFrozen();
+  if (batchDepth == 0) {
+    batchVerticesCapacityCount = nVerticesCapacityCount;
+    batchHalfedgesCapacityCount = nHalfedgesCapacityCount;
+    batchFacesCapacityCount = nFacesCapacityCount;
+  }
+  batchDepth++;
+}
+
+void HalfedgeMesh::endBatch() {
+  GC_SAFETY_ASSERT(batchDepth > 0, "endBatch() called without a matching beginBatch()");
+  batchDepth--;
+  if (batchDepth > 0) return;
+
+  // Invoke the expansion callbacks which were skipped, once for each list that grew
+  if (nVerticesCapacityCount != batchVerticesCapacityCount) {
+    for (auto& f : vertexExpandCallbackList) {
+      f(nVerticesCapacityCount);
+    }
+  }
+  if (nHalfedgesCapacityCount != batchHalfedgesCapacityCount) {
+    for (auto& f : halfedgeExpandCallbackList) {
+      f(nHalfedgesCapacityCount);
+    }
+    for (auto& f : edgeExpandCallbackList) {
+      f(nEdgesCapacity());
+    }
+  }
+  if (nFacesCapacityCount != batchFacesCapacityCount) {
+    for (auto& f : faceExpandCallbackList) {
+      f(nFacesCapacityCount);
+    }
+  }
+
+  compactAfterMutation();
+}
+
+void HalfedgeMesh::freeze() {
+  GC_SAFETY_ASSERT(!isInBatch(), "cannot freeze a mesh in a batch");
+  if (isFrozen()) return;
+  frozenContainerToken = std::make_shared<char>(0);
+}
+
+void HalfedgeMesh::unfreeze() {
+  if (!isFrozen()) return;
+  if (frozenContainerToken.use_count() != 1) {
+    throw std::runtime_error(
+        "cannot unfreeze a mesh while containers or dynamic elements created on the frozen mesh are alive");
+  }
+  frozenContainerToken.reset();
+}
+
+void HalfedgeMesh::checkNotFrozen() const {
+  if (isFrozen()) {
+    throw std::runtime_error("cannot mutate a frozen mesh");
+  }
+}
+
+void HalfedgeMesh::permuteVertices(const std::vector<size_t>& newToOld) {
+  checkNotFrozen();
+  GC_SAFETY_ASSERT(isCompressed() && !isInBatch(), "can only permute a compressed mesh, outside of a batch");
+  applyVertexPermutation(extendPermutation(newToOld, nVerticesFillCount, nVerticesCapacityCount, "vertex"));
+}
+
+void HalfedgeMesh::permuteEdges(const std::vector<size_t>& newToOld) {
+  checkNotFrozen();
+  GC_SAFETY_ASSERT(isCompressed() && !isInBatch(), "can only permute a compressed mesh, outside of a batch");
+  applyEdgePermutation(extendPermutation(newToOld, nEdgesFillCount(), nEdgesCapacity(), "edge"));
+}
+
+void HalfedgeMesh::permuteFaces(const std::vector<size_t>& newToOld) {
+  checkNotFrozen();
+  GC_SAFETY_ASSERT(isCompressed() && !isInBatch(), "can only permute a compressed mesh, outside of a batch");
+  // (the identity on the back of the buffer leaves boundary loops in place)
+  applyFacePermutation(extendPermutation(newToOld, nFacesFillCount, nFacesCapacityCount, "face"));
+}
+
+void HalfedgeMesh::applyVertexPermutation(const std::vector<size_t>& perm) {
+  std::vector<size_t> oldToNew = invertPermutation(perm);
+
+  for (size_t iHe = 0; iHe < nHalfedgesFillCount; iHe++) {
+    if (halfedgeIsDead(iHe)) continue;
+    heVertex[iHe] = oldToNew[heVertex[iHe]];
+  }
+  IndexVector newVHalfedge(nVerticesCapacityCount, INVALID_IND);
+  for (size_t iV = 0; iV < nVerticesFillCount; iV++) {
+    newVHalfedge[iV] = vHalfedge[perm[iV]];
+  }
+  vHalfedge = std::move(newVHalfedge);
+
+  isCanonicalFlag = false;
+
+  // Invoke callbacks
+  for (auto& f : vertexPermuteCallbackList) {
+    f(perm);
+  }
+  vertexDynamicElements.permute(oldToNew);
+}
+
+void HalfedgeMesh::applyEdgePermutation(const std::vector<size_t>& edgePerm) {
+
+  // Halfedges move along with their edges, since he = 2*e and he.twin() = 2*e+1
+  std::vector<size_t> perm(nHalfedgesCapacityCount);
+  for (size_t iE = 0; iE < edgePerm.size(); iE++) {
+    perm[2 * iE] = 2 * edgePerm[iE];
+    perm[2 * iE + 1] = 2 * edgePerm[iE] + 1;
+  }
+  std::vector<size_t> oldToNew = invertPermutation(perm);
+
+  IndexVector newHeNext(nHalfedgesCapacityCount, INVALID_IND);
+  IndexVector newHeVertex(nHalfedgesCapacityCount, INVALID_IND);
+  IndexVector newHeFace(nHalfedgesCapacityCount, INVALID_IND);
+  for (size_t iHe = 0; iHe < nHalfedgesFillCount; iHe++) {
+    if (halfedgeIsDead(perm[iHe])) continue;
+    newHeNext[iHe] = oldToNew[heNext[perm[iHe]]];
+    newHeVertex[iHe] = heVertex[perm[iHe]];
+    newHeFace[iHe] = heFace[perm[iHe]];
+  }
+  heNext = std::move(newHeNext);
+  heVertex = std::move(newHeVertex);
+  heFace = std::move(newHeFace);
+
+  for (size_t iV = 0; iV < nVerticesFillCount; iV++) {
+    if (vertexIsDead(iV)) continue;
+    vHalfedge[iV] = oldToNew[vHalfedge[iV]];
+  }
+  for (size_t iF = 0; iF < nFacesFillCount; iF++) {
+    if (faceIsDead(iF)) continue;
+    fHalfedge[iF] = oldToNew[fHalfedge[iF]];
+  }
+  for (size_t iF = nFacesCapacityCount - nBoundaryLoopsFillCount; iF < nFacesCapacityCount; iF++) {
+    fHalfedge[iF] = oldToNew[fHalfedge[iF]];
+  }
+
+  isCanonicalFlag = false;
+
+  // Invoke callbacks
+  for (auto& f : halfedgePermuteCallbackList) {
+    f(perm);
+  }
+  for (auto& f : edgePermuteCallbackList) {
+    f(edgePerm);
+  }
+  halfedgeDynamicElements.permute(oldToNew);
+  if (!edgeDynamicElements.empty()) {
+    edgeDynamicElements.permute(invertPermutation(edgePerm));
+  }
+}
+
+void HalfedgeMesh::applyFacePermutation(const std::vector<size_t>& perm) {
+  std::vector<size_t> oldToNew = invertPermutation(perm);
+
+  for (size_t iHe = 0; iHe < nHalfedgesFillCount; iHe++) {
+    if (halfedgeIsDead(iHe)) continue;
+    heFace[iHe] = oldToNew[heFace[iHe]];
+  }
+  IndexVector newFHalfedge = fHalfedge;
+  for (size_t iF = 0; iF < nFacesFillCount; iF++) {
+    newFHalfedge[iF] = fHalfedge[perm[iF]];
+  }
+  fHalfedge = std::move(newFHalfedge);
+
+  isCanonicalFlag = false;
+
+  // Invoke callbacks
+  for (auto& f : facePermuteCallbackList) {
+    f(perm);
+  }
+  faceDynamicElements.permute(oldToNew);
+}
+
+void HalfedgeMesh::compress() {
+  checkNotFrozen();
+  if (isCompressed()) return;
+  GC_SAFETY_ASSERT(!isInBatch(), "cannot compress a mesh in a batch");
+
+  compressVertices();
+  compressEdges();
+  compressFaces();
+
+  deadVertices.clear();
+  deadEdges.clear();
+  deadFaces.clear();
+  isCompressedFlag = true;
+}
+
+void HalfedgeMesh::compressVertices() {
+  if (nVerticesCount == nVerticesFillCount) return;
+  applyVertexPermutation(compressingPermutation(nVerticesFillCount, nVerticesCapacityCount,
+                                                [&](size_t iV) { return vertexIsDead(iV); }));
+  nVerticesFillCount = nVerticesCount;
+}
+
+void HalfedgeMesh::compressEdges() {
+  if (nHalfedgesCount == nHalfedgesFillCount) return;
+  applyEdgePermutation(
+      compressingPermutation(nEdgesFillCount(), nEdgesCapacity(), [&](size_t iE) { return edgeIsDead(iE); }));
+  nHalfedgesFillCount = nHalfedgesCount;
+}
+
+void HalfedgeMesh::compressFaces() {
+  if (nFacesCount == nFacesFillCount) return;
+  // (the space between the last face and the first boundary loop becomes boundary loop capacity)
+  applyFacePermutation(
+      compressingPermutation(nFacesFillCount, nFacesCapacityCount, [&](size_t iF) { return faceIsDead(iF); }));
+  nFacesFillCount = nFacesCount;
+}
+
+void HalfedgeMesh::compressIncrementally(size_t maxMoves) {
+  checkNotFrozen();
+  GC_SAFETY_ASSERT(!isInBatch(), "cannot compress a mesh in a batch");
+
+  // Repeatedly trim dead elements off the back of the buffer, then move the last element into a hole. Returns the
+  // moves which were made.
+  auto fillHoles = [&](std::vector<size_t>& holes, size_t& nFill, std::function<bool(size_t)> isDead,
+                       std::function<void(size_t, size_t)> move) {
+    std::vector<std::pair<size_t, size_t>> moves;
+    while (true) {
+      while (nFill > 0 && isDead(nFill - 1)) nFill--;
+      while (!holes.empty() && (holes.back() >= nFill || !isDead(holes.back()))) holes.pop_back();
+      if (holes.empty() || moves.size() == maxMoves) break;
+
+      size_t iTo = holes.back();
+      holes.pop_back();
+      move(nFill - 1, iTo);
+      moves.emplace_back(nFill - 1, iTo);
+      nFill--;
+    }
+    return moves;
+  };
+
+  // Vertices
+  std::vector<std::pair<size_t, size_t>> vertexMoves =
+      fillHoles(deadVertices, nVerticesFillCount, [&](size_t iV) { return vertexIsDead(iV); },
+                [&](size_t iFrom, size_t iTo) { moveVertex(iFrom, iTo); });
+  if (!vertexMoves.empty()) {
+    for (auto& f : vertexMoveCallbackList) {
+      f(vertexMoves);
+    }
+    vertexDynamicElements.move(vertexMoves);
+  }
+
+  // Edges, and their halfedges
+  size_t nEdgesFill = nEdgesFillCount();
+  std::vector<std::pair<size_t, size_t>> edgeMoves =
+      fillHoles(deadEdges, nEdgesFill, [&](size_t iE) { return edgeIsDead(iE); },
+                [&](size_t iFrom, size_t iTo) { moveEdge(iFrom, iTo); });
+  nHalfedgesFillCount = 2 * nEdgesFill;
+  if (!edgeMoves.empty()) {
+    std::vector<std::pair<size_t, size_t>> halfedgeMoves;
+    for (const std::pair<size_t, size_t>& m : edgeMoves) {
+      halfedgeMoves.emplace_back(2 * m.first, 2 * m.second);
+      halfedgeMoves.emplace_back(2 * m.first + 1, 2 * m.second + 1);
+    }
+    for (auto& f : halfedgeMoveCallbackList) {
+      f(halfedgeMoves);
+    }
+    for (auto& f : edgeMoveCallbackList) {
+      f(edgeMoves);
+    }
+    halfedgeDynamicElements.move(halfedgeMoves);
+    edgeDynamicElements.move(edgeMoves);
+  }
+
+  // Faces (the space freed at the back becomes boundary loop capacity)
+  std::vector<std::pair<size_t, size_t>> faceMoves =
+      fillHoles(deadFaces, nFacesFillCount, [&](size_t iF) { return faceIsDead(iF); },
+                [&](size_t iFrom, size_t iTo) { moveFace(iFrom, iTo); });
+  if (!faceMoves.empty()) {
+    for (auto& f : faceMoveCallbackList) {
+      f(faceMoves);
+    }
+    faceDynamicElements.move(faceMoves);
+  }
+
+  if (!vertexMoves.empty() || !edgeMoves.empty() || !faceMoves.empty()) {
+    isCanonicalFlag = false;
+  }
+  isCompressedFlag = nVerticesCount == nVerticesFillCount && nHalfedgesCount == nHalfedgesFillCount &&
+                     nFacesCount == nFacesFillCount;
+}
+
+void HalfedgeMesh::setAutoCompaction(size_t movesPerMutation, double tombstoneRatio) {
+  compactionMovesPerMutation = movesPerMutation;
+  compactionTombstoneRatio = tombstoneRatio;
+}
+
+void HalfedgeMesh::compactAfterMutation() {
+  if (isInBatch() || isCompressed()) return;
+
+  auto tooManyTombstones = [&](size_t nAlive, size_t nFill) {
+    return nFill > 0 && static_cast<double>(nFill - nAlive) > compactionTombstoneRatio * nFill;
+  };
+  if (tooManyTombstones(nVerticesCount, nVerticesFillCount) ||
+      tooManyTombstones(nHalfedgesCount, nHalfedgesFillCount) || tooManyTombstones(nFacesCount, nFacesFillCount)) {
+    compress();
+  } else if (compactionMovesPerMutation > 0) {
+    compressIncrementally(compactionMovesPerMutation);
+  }
+}
+
+void HalfedgeMesh::moveVertex(size_t iFrom, size_t iTo) {
+  vHalfedge[iTo] = vHalfedge[iFrom];
+  vHalfedge[iFrom] = INVALID_IND;
+
+  size_t iHe = vHalfedge[iTo];
+  do {
+    heVertex[iHe] = iTo;
+    iHe = heNext[heTwin(iHe)];
+  } while (iHe != vHalfedge[iTo]);
+}
+
+void HalfedgeMesh::moveEdge(size_t iFrom, size_t iTo) {
+  size_t heFromA = eHalfedge(iFrom);
+  size_t heFromB = heTwin(heFromA);
+  auto newIndex = [&](size_t iHe) {
+    if (iHe == heFromA) return eHalfedge(iTo);
+    if (iHe == heFromB) return heTwin(eHalfedge(iTo));
+    return iHe;
+  };
+
+  // Find the halfedges which come before each halfedge in their faces, by orbiting the tail vertex, before anything
+  // changes
+  auto prevHalfedge = [&](size_t iHe) {
+    size_t iCurr = iHe;
+    while (heNext[heTwin(iCurr)] != iHe) {
+      iCurr = heNext[heTwin(iCurr)];
+    }
+    return heTwin(iCurr);
+  };
+  size_t prevA = prevHalfedge(heFromA);
+  size_t prevB = prevHalfedge(heFromB);
+
+  for (size_t iHe : {heFromA, heFromB}) {
+    size_t iHeTo = newIndex(iHe);
+    heNext[iHeTo] = newIndex(heNext[iHe]);
+    heVertex[iHeTo] = heVertex[iHe];
+    heFace[iHeTo] = heFace[iHe];
+    if (vHalfedge[heVertex[iHe]] == iHe) vHalfedge[heVertex[iHe]] = iHeTo;
+    if (fHalfedge[heFace[iHe]] == iHe) fHalfedge[heFace[iHe]] = iHeTo;
+  }
+  heNext[newIndex(prevA)] = newIndex(heFromA);
+  heNext[newIndex(prevB)] = newIndex(heFromB);
+
+  heNext[heFromA] = INVALID_IND;
+  heNext[heFromB] = INVALID_IND;
+}
+
+void HalfedgeMesh::moveFace(size_t iFrom, size_t iTo) {
+  fHalfedge[iTo] = fHalfedge[iFrom];
+  fHalfedge[iFrom] = INVALID_IND;
+
+  size_t iHe = fHalfedge[iTo];
+  do {
+    heFace[iHe] = iTo;
+    iHe = heNext[iHe];
+  } while (iHe != fHalfedge[iTo]);
+}
+
 
 void HalfedgeMesh::validateConnectivity() {
 
@@ -1470,26 +2246,102 @@ Halfedge* HalfedgeMesh::getNewHalfedge(bool real) {
 }
 */
 
-Vertex HalfedgeMesh::getNewVertex() {
+void HalfedgeMesh::expandVertexCapacity(size_t newCapacity) {
 
-  // The boring case, when no resize is needed
-  if (nVerticesFillCount < nVerticesCapacityCount) {
-    // No work needed
+  // Resize internal arrays
+  vHalfedge.resize(newCapacity);
+
+  nVerticesCapacityCount = newCapacity;
+
+  // Invoke relevant callback functions (deferred to endBatch() while batching)
+  if (batchDepth == 0) {
+    for (auto& f : vertexExpandCallbackList) {
+      f(newCapacity);
+    }
   }
-  // The intesting case, where vectors resize
-  else {
-    size_t newCapacity = nVerticesCapacityCount * 2;
+}
 
-    // Resize internal arrays
-    vHalfedge.resize(newCapacity);
+void HalfedgeMesh::expandEdgeCapacity(size_t newEdgeCapacity) {
 
-    nVerticesCapacityCount = newCapacity;
+  // recall that these capacities should always be in sync, so we resize and expand for both edges and halfedges
+  size_t newCapacity = 2 * newEdgeCapacity;
 
-    // Invoke relevant callback functions
-    for (auto& f : vertexExpandCallbackList) {
+  // Resize internal arrays
+  heNext.resize(newCapacity);
+  heVertex.resize(newCapacity);
+  heFace.resize(newCapacity);
+
+  nHalfedgesCapacityCount = newCapacity;
+
+  // Invoke relevant callback functions (deferred to endBatch() while batching)
+  if (batchDepth == 0) {
+    for (auto& f : halfedgeExpandCallbackList) {
+      f(newCapacity);
+    }
+    for (auto& f : edgeExpandCallbackList) {
+      f(newEdgeCapacity);
+    }
+  }
+}
+
+void HalfedgeMesh::expandFaceCapacity(size_t newCapacity) {
+
+  // Resize internal arrays
+  fHalfedge.resize(newCapacity);
+
+  // Scooch boundary data back
+  for (size_t iBack = 0; iBack < nBoundaryLoopsFillCount; iBack++) {
+    size_t iOld = nFacesCapacityCount - iBack - 1;
+    size_t iNew = fHalfedge.size() - iBack - 1;
+    fHalfedge[iNew] = fHalfedge[iOld];
+    fHalfedge[iOld] = INVALID_IND; // will help catch bugs
+  }
+
+  // Scooch back he.face() indices that point to boundary loops
+  for (size_t iHe = 0; iHe < nHalfedgesFillCount; iHe++) {
+    if (halfedgeIsDead(iHe)) {
+      continue;
+    }
+    if (heFace[iHe] >= nFacesFillCount) {
+      heFace[iHe] += (newCapacity - nFacesCapacityCount);
+    }
+  }
+
+  nFacesCapacityCount = newCapacity;
+
+  // Invoke relevant callback functions (deferred to endBatch() while batching)
+  if (batchDepth == 0) {
+    for (auto& f : faceExpandCallbackList) {
       f(newCapacity);
     }
   }
+}
+
+void HalfedgeMesh::reserve(size_t nVertices, size_t nEdges, size_t nFaces) {
+  checkNotFrozen();
+
+  // Leave room for any dead elements which have not been compressed away, since they still occupy the buffers
+  size_t vertexCapacity = nVertices + (nVerticesFillCount - nVerticesCount);
+  size_t edgeCapacity = nEdges + (nHalfedgesFillCount - nHalfedgesCount) / 2;
+  size_t faceCapacity = nFaces + (nFacesFillCount - nFacesCount) + nBoundaryLoopsFillCount; // loops share the buffer
+
+  if (vertexCapacity > nVerticesCapacityCount) {
+    expandVertexCapacity(vertexCapacity);
+  }
+  if (edgeCapacity > nEdgesCapacity()) {
+    expandEdgeCapacity(edgeCapacity);
+  }
+  if (faceCapacity > nFacesCapacityCount) {
+    expandFaceCapacity(faceCapacity);
+  }
+}
+
+Vertex HalfedgeMesh::getNewVertex() {
+
+  // Expand if needed
+  if (nVerticesFillCount == nVerticesCapacityCount) {
+    expandVertexCapacity(std::max(nVerticesCapacityCount * 2, size_t(1)));
+  }
 
   nVerticesFillCount++;
   nVerticesCount++;
@@ -1500,42 +2352,13 @@ Vertex HalfedgeMesh::getNewVertex() {
 Halfedge HalfedgeMesh::getNewEdgeTriple(bool onBoundary) {
 
   // == Get two halfedges and one edge
-  // recall that these capacities should always be in sync, so we resize and expand for either both edges and halfedges,
-  // or neither
 
+  // Expand if needed
   if (nHalfedgesFillCount + 1 < nHalfedgesCapacityCount) {
     GC_SAFETY_ASSERT(nEdgesFillCount() < nHalfedgesCapacityCount / 2,
                      "edge capacity is out of sync with halfedge capacity");
-
-    // No work needed
   } else {
-
-    size_t initHalfedgeCapacity = nHalfedgesCapacityCount; // keep track before we start modifying for clarify
-
-    { // expand halfedge list
-      size_t newCapacity = initHalfedgeCapacity * 2;
-
-      // Resize internal arrays
-      heNext.resize(newCapacity);
-      heVertex.resize(newCapacity);
-      heFace.resize(newCapacity);
-
-      nHalfedgesCapacityCount = newCapacity;
-
-      // Invoke relevant callback functions
-      for (auto& f : halfedgeExpandCallbackList) {
-        f(newCapacity);
-      }
-    }
-
-    {                                            // expand edges
-      size_t newCapacity = initHalfedgeCapacity; // will be double he current edge capacity cout
-
-      // Invoke relevant callback functions
-      for (auto& f : edgeExpandCallbackList) {
-        f(newCapacity);
-      }
-    }
+    expandEdgeCapacity(std::max(nHalfedgesCapacityCount, size_t(1))); // doubles the edge capacity
   }
 
 
@@ -1600,47 +2423,39 @@ Edge* HalfedgeMesh::getNewEdge() {
 
 Face HalfedgeMesh::getNewFace() {
 
-  // The boring case, when no resize is needed
-  if (nFacesFillCount + nBoundaryLoopsCount < nFacesCapacityCount) {
-    // No work needed
+  // Expand if needed
+  if (nFacesFillCount + nBoundaryLoopsCount == nFacesCapacityCount) {
+    expandFaceCapacity(std::max(nFacesCapacityCount * 2, size_t(1)));
   }
-  // The intesting case, where vectors resize
-  else {
-    size_t newCapacity = nFacesCapacityCount * 2;
 
-    // Resize internal arrays
-    fHalfedge.resize(newCapacity);
-
-    // Scooch boundary data back
-    for (size_t iBack = 0; iBack < nBoundaryLoopsFillCount; iBack++) {
-      size_t iOld = nFacesCapacityCount - iBack - 1;
-      size_t iNew = fHalfedge.size() - iBack - 1;
-      fHalfedge[iNew] = fHalfedge[iOld];
-      fHalfedge[iOld] = INVALID_IND; // will help catch bugs
-    }
-
-    // Scooch back he.face() indices that point to boundary loops
-    for (size_t iHe = 0; iHe < nHalfedgesFillCount; iHe++) {
-      if (halfedgeIsDead(iHe)) {
-        continue;
-      }
-      if (heFace[iHe] >= nFacesFillCount) {
-        heFace[iHe] += (newCapacity - nFacesCapacityCount);
-      }
-    }
+  nFacesCount++;
+  nFacesFillCount++;
 
-    nFacesCapacityCount = newCapacity;
+  return Face(this, nFacesFillCount - 1);
+}
 
-    // Invoke relevant callback functions
-    for (auto& f : faceExpandCallbackList) {
-      f(newCapacity);
-    }
+void HalfedgeMesh::deleteEdgeTriple(Halfedge he) {
+  for (size_t iHe : {he.getIndex(), heTwin(he.getIndex())}) {
+    if (heIsInterior(iHe)) nInteriorHalfedgesCount--;
+    heNext[iHe] = INVALID_IND;
   }
+  nHalfedgesCount -= 2;
+  deadEdges.push_back(heEdge(he.getIndex()));
+  isCompressedFlag = false;
+}
 
-  nFacesCount++;
-  nFacesFillCount++;
+void HalfedgeMesh::deleteElement(Vertex v) {
+  vHalfedge[v.getIndex()] = INVALID_IND;
+  nVerticesCount--;
+  deadVertices.push_back(v.getIndex());
+  isCompressedFlag = false;
+}
 
-  return Face(this, nFacesFillCount - 1);
+void HalfedgeMesh::deleteElement(Face f) {
+  fHalfedge[f.getIndex()] = INVALID_IND;
+  nFacesCount--;
+  deadFaces.push_back(f.getIndex());
+  isCompressedFlag = false;
 }
 
 /*
@@ -35,7 +35,8 @@ HeatMethodDistanceSolver::HeatMethodDistanceSolver(IntrinsicGeometryInterface& g
 
   // Heat operator
   SparseMatrix<double> heatOp = M + shortTime * L;
-  heatSolver.reset(new PositiveDefiniteSolver<double>(heatOp));
+  // M + tL is strictly positive definite, so on large meshes it can use a supernodal LLt
+  heatSolver.reset(new PositiveDefiniteSolver<double>(heatOp, CholeskyMode::Auto));
 
   // Poisson solver
   poissonSolver.reset(new PositiveDefiniteSolver<double>(L));
@@ -74,17 +75,16 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
 
 
   // === Build RHS
-  VertexData<double> rhs(mesh, 0.);
+  Vector<double> rhsVec = Vector<double>::Zero(mesh.nVertices());
   for (const SurfacePoint& p : sourcePoints) {
     SurfacePoint faceP = p.inSomeFace();
 
     // Set initial values at the three adjacent vertices
     Halfedge he = faceP.face.halfedge();
-    rhs[he.vertex()] += faceP.faceCoords.x;
-    rhs[he.next().vertex()] += faceP.faceCoords.y;
-    rhs[he.next().next().vertex()] += faceP.faceCoords.z;
+    rhsVec[geom.vertexIndices[he.vertex()]] += faceP.faceCoords.x;
+    rhsVec[geom.vertexIndices[he.next().vertex()]] += faceP.faceCoords.y;
+    rhsVec[geom.vertexIndices[he.next().next().vertex()]] += faceP.faceCoords.z;
   }
-  Vector<double> rhsVec = rhs.toVector();
 
 
   // === Solve heat
@@ -156,7 +156,7 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
   distDiffAtSource /= weightSum;
 
   double shift = -distDiffAtSource;
-  distVec = distVec.array() + shift;
+  distVec.array() += shift;
 
   geom.unrequireHalfedgeVectorsInFace();
   geom.unrequireHalfedgeCotanWeights();
@@ -2,6 +2,7 @@
 
 //#include "geometrycentral/surface/discrete_operators.h"
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 
@@ -16,6 +17,7 @@ IntrinsicGeometryInterface::IntrinsicGeometryInterface(HalfedgeMesh& mesh_) :
   BaseGeometryInterface(mesh_), 
 
   edgeLengthsQ              (&edgeLengths,                  std::bind(&IntrinsicGeometryInterface::computeEdgeLengths, this),               quantities),
+  triangleQuantitiesQ       (&triangleQuantitiesPlaceholder,std::bind(&IntrinsicGeometryInterface::computeTriangleQuantities, this),        quantities),
   faceAreasQ                (&faceAreas,                    std::bind(&IntrinsicGeometryInterface::computeFaceAreas, this),                 quantities),
   vertexDualAreasQ          (&vertexDualAreas,              std::bind(&IntrinsicGeometryInterface::computeVertexDualAreas, this),           quantities),
   cornerAnglesQ             (&cornerAngles,                 std::bind(&IntrinsicGeometryInterface::computeCornerAngles, this),              quantities),
@@ -269,6 +271,81 @@ void IntrinsicGeometryInterface::computeEdgeCotanWeights() {
 void IntrinsicGeometryInterface::requireEdgeCotanWeights() { edgeCotanWeightsQ.require(); }
 void IntrinsicGeometryInterface::unrequireEdgeCotanWeights() { edgeCotanWeightsQ.unrequire(); }
 
+// Triangle quantities
+// Fused version of computeFaceAreas(), computeVertexDualAreas(), computeCornerAngles(), computeHalfedgeCotanWeights()
+// and computeEdgeCotanWeights(), which reads the three edge lengths of each face once and computes everything which
+// depends on them. The arithmetic matches the separate versions exactly, so the results are identical.
+void IntrinsicGeometryInterface::computeTriangleQuantities() {
+  if (faceAreasQ.computed && vertexDualAreasQ.computed && cornerAnglesQ.computed && halfedgeCotanWeightsQ.computed &&
+      edgeCotanWeightsQ.computed) {
+    return;
+  }
+  edgeLengthsQ.ensureHave();
+
+  FaceData<double> newFaceAreas(mesh);
+  VertexData<double> newVertexDualAreas(mesh, 0.);
+  CornerData<double> newCornerAngles(mesh);
+  HalfedgeData<double> newHalfedgeCotanWeights(mesh, 0.);
+  EdgeData<double> newEdgeCotanWeights(mesh, 0.);
+
+  for (Face f : mesh.faces()) {
+    std::array<Halfedge, 3> he;
+    he[0] = f.halfedge();
+    he[1] = he[0].next();
+    he[2] = he[1].next();
+    GC_SAFETY_ASSERT(he[2].next() == he[0], "faces mush be triangular");
+
+    std::array<double, 3> l{{edgeLengths[he[0].edge()], edgeLengths[he[1].edge()], edgeLengths[he[2].edge()]}};
+
+    // Herons formula
+    double s = (l[0] + l[1] + l[2]) / 2.0;
+    double arg = s * (s - l[0]) * (s - l[1]) * (s - l[2]);
+    arg = std::fmax(0., arg);
+    double area = std::sqrt(arg);
+    newFaceAreas[f] = area;
+
+    for (int i = 0; i < 3; i++) {
+      double l_ij = l[i];
+      double l_jk = l[(i + 1) % 3];
+      double l_ki = l[(i + 2) % 3];
+
+      newVertexDualAreas[he[i].vertex()] += area / 3.0;
+
+      // The corner at the tail of he[i] is between it and the previous halfedge
+      double q = (l_ij * l_ij + l_ki * l_ki - l_jk * l_jk) / (2. * l_ij * l_ki);
+      q = clamp(q, -1.0, 1.0);
+      newCornerAngles[he[i].corner()] = std::acos(q);
+
+      double cotValue = (-l_ij * l_ij + l_jk * l_jk + l_ki * l_ki) / (4. * area);
+      newHalfedgeCotanWeights[he[i]] = cotValue / 2;
+      newEdgeCotanWeights[he[i].edge()] += cotValue / 2;
+    }
+  }
+
+  // Store the results, except for any quantities which were computed separately in the meantime
+  faceAreasQ.ensureHaveWith([&]() { faceAreas = std::move(newFaceAreas); });
+  vertexDualAreasQ.ensureHaveWith([&]() { vertexDualAreas = std::move(newVertexDualAreas); });
+  cornerAnglesQ.ensureHaveWith([&]() { cornerAngles = std::move(newCornerAngles); });
+  halfedgeCotanWeightsQ.ensureHaveWith([&]() { halfedgeCotanWeights = std::move(newHalfedgeCotanWeights); });
+  edgeCotanWeightsQ.ensureHaveWith([&]() { edgeCotanWeights = std::move(newEdgeCotanWeights); });
+}
+void IntrinsicGeometryInterface::requireTriangleQuantities() {
+  triangleQuantitiesQ.require();
+  faceAreasQ.require();
+  vertexDualAreasQ.require();
+  cornerAnglesQ.require();
+  halfedgeCotanWeightsQ.require();
+  edgeCotanWeightsQ.require();
+}
+void IntrinsicGeometryInterface::unrequireTriangleQuantities() {
+  triangleQuantitiesQ.unrequire();
+  faceAreasQ.unrequire();
+  vertexDualAreasQ.unrequire();
+  cornerAnglesQ.unrequire();
+  halfedgeCotanWeightsQ.unrequire();
+  edgeCotanWeightsQ.unrequire();
+}
+
 
 // Halfedge vectors in face
 void IntrinsicGeometryInterface::computeHalfedgeVectorsInFace() {
@@ -396,31 +473,128 @@ void IntrinsicGeometryInterface::unrequireTransportVectorsAlongHalfedge() {
 }
 
 
+// Vertex adjacency sparsity pattern
+void IntrinsicGeometryInterface::ensureHaveVertexAdjacencyPattern() {
+  vertexIndicesQ.ensureHave();
+  halfedgeIndicesQ.ensureHave();
+
+  std::lock_guard<std::mutex> lock(vertexAdjacencyPatternMutex);
+  VertexAdjacencyPattern& pattern = vertexAdjacencyPattern;
+  size_t nVerts = mesh.nVertices();
+  size_t nHalfedges = mesh.nHalfedges();
+
+  // Check that the cached pattern still matches the connectivity: every halfedge must point to its own entry
+  auto inColumn = [&](size_t slot, size_t iCol, size_t iRow) {
+    return slot >= static_cast<size_t>(pattern.outerIndex[iCol]) &&
+           slot < static_cast<size_t>(pattern.outerIndex[iCol + 1]) &&
+           static_cast<size_t>(pattern.innerIndex[slot]) == iRow;
+  };
+  bool valid = pattern.diagonalSlots.size() == nVerts && pattern.halfedgeSlots.size() == nHalfedges;
+  if (valid) {
+    for (size_t iV = 0; iV < nVerts && valid; iV++) {
+      valid = inColumn(pattern.diagonalSlots[iV], iV, iV);
+    }
+    for (Halfedge he : mesh.halfedges()) {
+      if (!valid) break;
+      size_t iTail = vertexIndices[he.vertex()];
+      size_t iTip = vertexIndices[he.twin().vertex()];
+      valid = inColumn(pattern.halfedgeSlots[halfedgeIndices[he]], iTail, iTip);
+    }
+  }
+  if (valid) {
+    return;
+  }
+
+  // Otherwise, rebuild it. Bucket the halfedges by tail vertex, which gives the columns.
+  std::vector<size_t> heTip(nHalfedges);
+  std::vector<size_t> columnStart(nVerts + 1, 0);
+  for (Halfedge he : mesh.halfedges()) {
+    heTip[halfedgeIndices[he]] = vertexIndices[he.twin().vertex()];
+    columnStart[vertexIndices[he.vertex()] + 1]++;
+  }
+  for (size_t iV = 0; iV < nVerts; iV++) {
+    columnStart[iV + 1] += columnStart[iV];
+  }
+  std::vector<size_t> columnHalfedges(nHalfedges);
+  std::vector<size_t> columnFill(columnStart.begin(), columnStart.end() - 1);
+  for (Halfedge he : mesh.halfedges()) {
+    columnHalfedges[columnFill[vertexIndices[he.vertex()]]++] = halfedgeIndices[he];
+  }
+
+  // Sort each column by row, merging the diagonal in and deduplicating rows (in intrinsic triangulations, several
+  // edges may connect the same pair of vertices)
+  pattern.outerIndex.assign(nVerts + 1, 0);
+  pattern.innerIndex.clear();
+  pattern.innerIndex.reserve(nVerts + nHalfedges);
+  pattern.diagonalSlots.assign(nVerts, 0);
+  pattern.halfedgeSlots.assign(nHalfedges, 0);
+  for (size_t iV = 0; iV < nVerts; iV++) {
+    auto colBegin = columnHalfedges.begin() + columnStart[iV];
+    auto colEnd = columnHalfedges.begin() + columnStart[iV + 1];
+    std::sort(colBegin, colEnd, [&](size_t iHeA, size_t iHeB) { return heTip[iHeA] < heTip[iHeB]; });
+
+    auto addEntry = [&](size_t iRow) {
+      if (pattern.innerIndex.size() == static_cast<size_t>(pattern.outerIndex[iV]) ||
+          static_cast<size_t>(pattern.innerIndex.back()) != iRow) {
+        pattern.innerIndex.push_back(static_cast<int>(iRow));
+      }
+      return pattern.innerIndex.size() - 1;
+    };
+
+    bool haveDiagonal = false;
+    for (auto it = colBegin; it != colEnd; ++it) {
+      size_t iRow = heTip[*it];
+      if (!haveDiagonal && iRow >= iV) {
+        pattern.diagonalSlots[iV] = addEntry(iV);
+        haveDiagonal = true;
+      }
+      pattern.halfedgeSlots[*it] = addEntry(iRow);
+    }
+    if (!haveDiagonal) {
+      pattern.diagonalSlots[iV] = addEntry(iV);
+    }
+    pattern.outerIndex[iV + 1] = static_cast<int>(pattern.innerIndex.size());
+  }
+}
+
+template <typename T>
+void IntrinsicGeometryInterface::initializeFromVertexAdjacencyPattern(Eigen::SparseMatrix<T>& matrix) {
+  const VertexAdjacencyPattern& pattern = vertexAdjacencyPattern;
+  long int n = static_cast<long int>(pattern.diagonalSlots.size());
+  long int nnz = static_cast<long int>(pattern.innerIndex.size());
+
+  // Only touch the structure if it does not match already (e.g. the first time, or if the mesh changed)
+  bool matches = matrix.rows() == n && matrix.cols() == n && matrix.isCompressed() && matrix.nonZeros() == nnz &&
+                 std::equal(pattern.outerIndex.begin(), pattern.outerIndex.end(), matrix.outerIndexPtr()) &&
+                 std::equal(pattern.innerIndex.begin(), pattern.innerIndex.end(), matrix.innerIndexPtr());
+  if (!matches) {
+    matrix.resize(n, n);
+    matrix.resizeNonZeros(nnz);
+    std::copy(pattern.outerIndex.begin(), pattern.outerIndex.end(), matrix.outerIndexPtr());
+    std::copy(pattern.innerIndex.begin(), pattern.innerIndex.end(), matrix.innerIndexPtr());
+  }
+
+  std::fill(matrix.valuePtr(), matrix.valuePtr() + nnz, T(0.));
+}
+
+
 // Cotan Laplacian
 void IntrinsicGeometryInterface::computeCotanLaplacian() {
   vertexIndicesQ.ensureHave();
+  halfedgeIndicesQ.ensureHave();
   edgeCotanWeightsQ.ensureHave();
 
-  cotanLaplacian = Eigen::SparseMatrix<double>(mesh.nVertices(), mesh.nVertices());
-  std::vector<Eigen::Triplet<double>> tripletList;
-
-  for (Edge e : mesh.edges()) {
-    Halfedge he = e.halfedge();
-    Vertex vTail = he.vertex();
-    Vertex vHead = he.twin().vertex();
-
-    size_t iVHead = vertexIndices[vHead];
-    size_t iVTail = vertexIndices[vTail];
+  ensureHaveVertexAdjacencyPattern();
+  initializeFromVertexAdjacencyPattern(cotanLaplacian);
+  const VertexAdjacencyPattern& pattern = vertexAdjacencyPattern;
+  double* values = cotanLaplacian.valuePtr();
 
-    double weight = edgeCotanWeights[e];
+  for (Halfedge he : mesh.halfedges()) {
+    double weight = edgeCotanWeights[he.edge()];
 
-    tripletList.emplace_back(iVTail, iVTail, weight);
-    tripletList.emplace_back(iVHead, iVHead, weight);
-    tripletList.emplace_back(iVTail, iVHead, -weight);
-    tripletList.emplace_back(iVHead, iVTail, -weight);
+    values[pattern.diagonalSlots[vertexIndices[he.vertex()]]] += weight;
+    values[pattern.halfedgeSlots[halfedgeIndices[he]]] -= weight;
   }
-
-  cotanLaplacian.setFromTriplets(tripletList.begin(), tripletList.end());
 }
 void IntrinsicGeometryInterface::requireCotanLaplacian() { cotanLaplacianQ.require(); }
 void IntrinsicGeometryInterface::unrequireCotanLaplacian() { cotanLaplacianQ.unrequire(); }
@@ -447,36 +621,25 @@ void IntrinsicGeometryInterface::unrequireVertexLumpedMassMatrix() { vertexLumpe
 // Vertex Galerkin mass matrix
 void IntrinsicGeometryInterface::computeVertexGalerkinMassMatrix() {
   vertexIndicesQ.ensureHave();
+  halfedgeIndicesQ.ensureHave();
   faceAreasQ.ensureHave();
 
-  std::vector<Eigen::Triplet<double>> triplets;
+  ensureHaveVertexAdjacencyPattern();
+  initializeFromVertexAdjacencyPattern(vertexGalerkinMassMatrix);
+  const VertexAdjacencyPattern& pattern = vertexAdjacencyPattern;
+  double* values = vertexGalerkinMassMatrix.valuePtr();
+
   for (Face f : mesh.faces()) {
     double area = faceAreas[f];
+    GC_SAFETY_ASSERT(f.halfedge().next().next().next() == f.halfedge(), "faces must be triangular");
 
-    // Gather indices for vertices on faces
-    Halfedge he = f.halfedge();
-    Vertex vA = he.vertex();
-    he = he.next();
-    Vertex vB = he.vertex();
-    he = he.next();
-    Vertex vC = he.vertex();
-    GC_SAFETY_ASSERT(he.next() == f.halfedge(), "faces must be triangular");
-
-    std::array<size_t, 3> indices{vertexIndices[vA], vertexIndices[vB], vertexIndices[vC]};
-
-    // Set entries
-    for (int root = 0; root < 3; root++) {
-      size_t i = indices[root];
-      size_t j = indices[(root + 1) % 3];
-      size_t k = indices[(root + 2) % 3];
-      triplets.emplace_back(i, i, area / 6.);
-      triplets.emplace_back(i, j, area / 12.);
-      triplets.emplace_back(i, k, area / 12.);
+    // Each halfedge of the face contributes to the diagonal at its tail, and to both entries for its edge
+    for (Halfedge he : f.adjacentHalfedges()) {
+      values[pattern.diagonalSlots[vertexIndices[he.vertex()]]] += area / 6.;
+      values[pattern.halfedgeSlots[halfedgeIndices[he]]] += area / 12.;
+      values[pattern.halfedgeSlots[halfedgeIndices[he.twin()]]] += area / 12.;
     }
   }
-
-  vertexGalerkinMassMatrix = Eigen::SparseMatrix<double>(mesh.nVertices(), mesh.nVertices());
-  vertexGalerkinMassMatrix.setFromTriplets(triplets.begin(), triplets.end());
 }
 void IntrinsicGeometryInterface::requireVertexGalerkinMassMatrix() { vertexGalerkinMassMatrixQ.require(); }
 void IntrinsicGeometryInterface::unrequireVertexGalerkinMassMatrix() { vertexGalerkinMassMatrixQ.unrequire(); }
@@ -487,23 +650,24 @@ void IntrinsicGeometryInterface::computeVertexConnectionLaplacian() {
   vertexIndicesQ.ensureHave();
   edgeCotanWeightsQ.ensureHave();
   transportVectorsAlongHalfedgeQ.ensureHave();
+  halfedgeIndicesQ.ensureHave();
 
+  ensureHaveVertexAdjacencyPattern();
+  initializeFromVertexAdjacencyPattern(vertexConnectionLaplacian);
+  const VertexAdjacencyPattern& pattern = vertexAdjacencyPattern;
+  std::complex<double>* values = vertexConnectionLaplacian.valuePtr();
 
-  std::vector<Eigen::Triplet<std::complex<double>>> triplets;
   for (Halfedge he : mesh.halfedges()) {
 
     size_t iTail = vertexIndices[he.vertex()];
-    size_t iTip = vertexIndices[he.twin().vertex()];
 
     double weight = edgeCotanWeights[he.edge()];
     Vector2 rot = transportVectorsAlongHalfedge[he.twin()];
 
-    triplets.emplace_back(iTail, iTail, weight);
-    triplets.emplace_back(iTail, iTip, -weight * rot);
+    // The (tail, tip) entry is the twin's (tip, tail) entry
+    values[pattern.diagonalSlots[iTail]] += weight;
+    values[pattern.halfedgeSlots[halfedgeIndices[he.twin()]]] += std::complex<double>(-weight * rot);
   }
-
-  vertexConnectionLaplacian = Eigen::SparseMatrix<std::complex<double>>(mesh.nVertices(), mesh.nVertices());
-  vertexConnectionLaplacian.setFromTriplets(triplets.begin(), triplets.end());
 }
 void IntrinsicGeometryInterface::requireVertexConnectionLaplacian() { vertexConnectionLaplacianQ.require(); }
 void IntrinsicGeometryInterface::unrequireVertexConnectionLaplacian() { vertexConnectionLaplacianQ.unrequire(); }
@@ -563,9 +727,17 @@ void IntrinsicGeometryInterface::computeDECOperators() {
   }
 
 
+  // The exterior derivatives are assembled directly in compressed form. Rows are visited in increasing order, so each
+  // entry is appended to the end of its column's reserved space.
+
   { // D0
+    Eigen::VectorXi columnSizes = Eigen::VectorXi::Zero(nVerts);
+    for (Edge e : mesh.edges()) {
+      columnSizes[vertexIndices[e.halfedge().vertex()]]++;
+      columnSizes[vertexIndices[e.halfedge().twin().vertex()]]++;
+    }
     d0 = Eigen::SparseMatrix<double>(nEdges, nVerts);
-    std::vector<Eigen::Triplet<double>> tripletList;
+    d0.reserve(columnSizes);
 
     for (Edge e : mesh.edges()) {
       size_t iEdge = edgeIndices[e];
@@ -574,18 +746,18 @@ void IntrinsicGeometryInterface::computeDECOperators() {
       Vertex vHead = he.twin().vertex();
 
       size_t iVHead = vertexIndices[vHead];
-      tripletList.emplace_back(iEdge, iVHead, 1.0);
+      d0.coeffRef(iEdge, iVHead) += 1.0;
 
       size_t iVTail = vertexIndices[vTail];
-      tripletList.emplace_back(iEdge, iVTail, -1.0);
+      d0.coeffRef(iEdge, iVTail) += -1.0;
     }
 
-    d0.setFromTriplets(tripletList.begin(), tripletList.end());
+    d0.makeCompressed();
   }
 
   { // D1
     d1 = Eigen::SparseMatrix<double>(nFaces, nEdges);
-    std::vector<Eigen::Triplet<double>> tripletList;
+    d1.reserve(Eigen::VectorXi::Constant(nEdges, 2));
 
     for (Face f : mesh.faces()) {
       size_t iFace = faceIndices[f];
@@ -593,11 +765,11 @@ void IntrinsicGeometryInterface::computeDECOperators() {
       for (Halfedge he : f.adjacentHalfedges()) {
         size_t iEdge = edgeIndices[he.edge()];
         double sign = (he == he.edge().halfedge()) ? (1.0) : (-1.0);
-        tripletList.emplace_back(iFace, iEdge, sign);
+        d1.coeffRef(iFace, iEdge) += sign;
       }
     }
 
-    d1.setFromTriplets(tripletList.begin(), tripletList.end());
+    d1.makeCompressed();
   }
 }
 void IntrinsicGeometryInterface::requireDECOperators() { DECOperatorsQ.require(); }
@@ -0,0 +1,177 @@
+#include "geometrycentral/surface/mesh_ordering.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace geometrycentral {
+namespace surface {
+
+namespace {
+
+// Spread the low 21 bits of x so that there are two zero bits between each
+uint64_t spreadBits(uint64_t x) {
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffff;
+  x = (x | x << 16) & 0x1f0000ff0000ff;
+  x = (x | x << 8) & 0x100f00f00f00f00f;
+  x = (x | x << 4) & 0x10c30c30c30c30c3;
+  x = (x | x << 2) & 0x1249249249249249;
+  return x;
+}
+
+// Order elements by a key in [0, nKeys), keeping the current order for ties
+template <typename E, typename R>
+std::vector<size_t> orderByKey(R range, size_t nElements, size_t nKeys, const std::function<size_t(E)>& key) {
+  std::vector<size_t> keyStart(nKeys + 1, 0);
+  for (E e : range) {
+    keyStart[key(e) + 1]++;
+  }
+  for (size_t i = 0; i < nKeys; i++) {
+    keyStart[i + 1] += keyStart[i];
+  }
+  std::vector<size_t> newToOld(nElements);
+  for (E e : range) {
+    newToOld[keyStart[key(e)]++] = e.getIndex();
+  }
+  return newToOld;
+}
+
+} // namespace
+
+std::vector<size_t> mortonVertexOrder(VertexPositionGeometry& geometry) {
+  HalfedgeMesh& mesh = geometry.mesh;
+  GC_SAFETY_ASSERT(mesh.isCompressed(), "mesh must be compressed");
+
+  // Bounding box
+  Vector3 bboxMin{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                  std::numeric_limits<double>::infinity()};
+  Vector3 bboxMax = -bboxMin;
+  for (Vertex v : mesh.vertices()) {
+    bboxMin = componentwiseMin(bboxMin, geometry.inputVertexPositions[v]);
+    bboxMax = componentwiseMax(bboxMax, geometry.inputVertexPositions[v]);
+  }
+  double extent = std::max(std::max(bboxMax.x - bboxMin.x, bboxMax.y - bboxMin.y), bboxMax.z - bboxMin.z);
+  double scale = extent > 0. ? (0x1fffff / extent) : 0.;
+
+  // Quantize positions to 21 bits per axis, and interleave
+  std::vector<std::pair<uint64_t, size_t>> codes;
+  codes.reserve(mesh.nVertices());
+  for (Vertex v : mesh.vertices()) {
+    Vector3 p = (geometry.inputVertexPositions[v] - bboxMin) * scale;
+    uint64_t code = spreadBits(static_cast<uint64_t>(p.x)) | (spreadBits(static_cast<uint64_t>(p.y)) << 1) |
+                    (spreadBits(static_cast<uint64_t>(p.z)) << 2);
+    codes.emplace_back(code, v.getIndex());
+  }
+  std::sort(codes.begin(), codes.end());
+
+  std::vector<size_t> newToOld(codes.size());
+  for (size_t i = 0; i < codes.size(); i++) {
+    newToOld[i] = codes[i].second;
+  }
+  return newToOld;
+}
+
+std::vector<size_t> reverseCuthillMcKeeVertexOrder(HalfedgeMesh& mesh) {
+  GC_SAFETY_ASSERT(mesh.isCompressed(), "mesh must be compressed");
+  size_t nV = mesh.nVertices();
+
+  std::vector<size_t> degree(nV);
+  for (Vertex v : mesh.vertices()) {
+    degree[v.getIndex()] = v.degree();
+  }
+
+  // Breadth-first search from a vertex, visiting neighbors in order of increasing degree. Appends the visited vertices
+  // to order, and returns the index in order where the last level begins.
+  std::vector<char> visited(nV, false);
+  std::vector<size_t> neighbors;
+  auto search = [&](size_t iStart, std::vector<size_t>& order) {
+    size_t levelStart = order.size();
+    size_t levelEnd = order.size() + 1;
+    size_t lastLevelStart = levelStart;
+    order.push_back(iStart);
+    visited[iStart] = true;
+    for (size_t i = levelStart; i < order.size(); i++) {
+      if (i == levelEnd) {
+        lastLevelStart = levelEnd;
+        levelEnd = order.size();
+      }
+      neighbors.clear();
+      for (Vertex n : mesh.vertex(order[i]).adjacentVertices()) {
+        if (!visited[n.getIndex()]) {
+          visited[n.getIndex()] = true;
+          neighbors.push_back(n.getIndex());
+        }
+      }
+      std::stable_sort(neighbors.begin(), neighbors.end(),
+                       [&](size_t a, size_t b) { return degree[a] < degree[b]; });
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+    return lastLevelStart;
+  };
+
+  // Consider starting vertices in order of increasing degree
+  std::vector<size_t> byDegree(nV);
+  for (size_t iV = 0; iV < nV; iV++) byDegree[iV] = iV;
+  std::stable_sort(byDegree.begin(), byDegree.end(), [&](size_t a, size_t b) { return degree[a] < degree[b]; });
+
+  std::vector<size_t> order;
+  order.reserve(nV);
+  std::vector<size_t> scratch;
+  for (size_t iStart : byDegree) {
+    if (visited[iStart]) continue;
+
+    // Find a pseudo-peripheral start vertex for this component: the lowest-degree vertex in the last level of a search
+    // from a low-degree vertex
+    scratch.clear();
+    size_t lastLevelStart = search(iStart, scratch);
+    size_t iPeripheral = scratch[lastLevelStart];
+    for (size_t i = lastLevelStart; i < scratch.size(); i++) {
+      if (degree[scratch[i]] < degree[iPeripheral]) iPeripheral = scratch[i];
+    }
+    for (size_t iV : scratch) visited[iV] = false;
+
+    search(iPeripheral, order);
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+void applyVertexOrder(HalfedgeMesh& mesh, const std::vector<size_t>& vertexNewToOld) {
+  mesh.permuteVertices(vertexNewToOld);
+
+  // Faces and edges follow their lowest-index vertex
+  size_t nV = mesh.nVertices();
+  std::function<size_t(Face)> faceKey = [](Face f) {
+    size_t minInd = INVALID_IND;
+    for (Vertex v : f.adjacentVertices()) minInd = std::min(minInd, v.getIndex());
+    return minInd;
+  };
+  mesh.permuteFaces(orderByKey<Face>(mesh.faces(), mesh.nFaces(), nV, faceKey));
+
+  std::function<size_t(Edge)> edgeKey = [](Edge e) {
+    return std::min(e.halfedge().vertex().getIndex(), e.halfedge().twin().vertex().getIndex());
+  };
+  mesh.permuteEdges(orderByKey<Edge>(mesh.edges(), mesh.nEdges(), nV, edgeKey));
+}
+
+void reorderForLocality(VertexPositionGeometry& geometry, MeshOrdering ordering) {
+  std::vector<size_t> vertexOrder;
+  switch (ordering) {
+  case MeshOrdering::SpaceFillingCurve:
+    vertexOrder = mortonVertexOrder(geometry);
+    break;
+  case MeshOrdering::ReverseCuthillMcKee:
+    vertexOrder = reverseCuthillMcKeeVertexOrder(geometry.mesh);
+    break;
+  }
+
+  applyVertexOrder(geometry.mesh, vertexOrder);
+  geometry.refreshQuantities();
+}
+
+} // namespace surface
+} // namespace geometrycentral
@@ -7,6 +7,7 @@
 
 #include "happly.h"
 
+#include <cstdint>
 #include <iostream>
 #include <limits>
 
@@ -62,9 +63,135 @@ void stripUnusedVertices(std::vector<Vector3>& positions, std::vector<std::vecto
   }
 }
 
+// strip unused vertices from flat face-vertex lists
+template <typename T>
+void stripUnusedVertices(std::vector<Vector3>& positions, std::vector<T>& faceIndices) {
+
+  size_t nVert = positions.size();
+
+  // Find any unused vertices
+  std::vector<char> vertexUsed(nVert, false);
+  size_t nUsedVerts = 0;
+  for (T i : faceIndices) {
+    // Make sure we can safely index positions
+    GC_SAFETY_ASSERT(i < positions.size(),
+                     "face index list has a vertex index which is greater than the number of vertices");
+
+    if (!vertexUsed[i]) {
+      vertexUsed[i] = true;
+      nUsedVerts++;
+    }
+  }
+
+  // Early exit if dense
+  if (nUsedVerts == nVert) {
+    return;
+  }
+
+  // Else: strip unused vertices and re-index faces
+  size_t nNewVertices = 0;
+  std::vector<size_t> oldToNewVertexInd(nVert);
+  for (size_t iV = 0; iV < nVert; iV++) {
+    if (vertexUsed[iV]) {
+      oldToNewVertexInd[iV] = nNewVertices;
+      positions[nNewVertices] = positions[iV];
+      nNewVertices++;
+    }
+  }
+  positions.resize(nNewVertices);
+  for (T& i : faceIndices) {
+    i = static_cast<T>(oldToNewVertexInd[i]);
+  }
+}
+
 
 // Mesh loader helpers
 namespace {
+
+// Convert a face-vertex list to a flat list with 32-bit indices (see HalfedgeMesh constructors), releasing the original
+// as we go
+void flattenFaceList(std::vector<std::vector<size_t>>& polygons, std::vector<uint32_t>& faceIndices,
+                     std::vector<size_t>& faceStart) {
+
+  size_t nCorners = 0;
+  for (const std::vector<size_t>& poly : polygons) {
+    nCorners += poly.size();
+  }
+
+  faceIndices.clear();
+  faceIndices.reserve(nCorners);
+  faceStart.clear();
+  faceStart.reserve(polygons.size() + 1);
+
+  faceStart.push_back(0);
+  for (std::vector<size_t>& poly : polygons) {
+    for (size_t i : poly) {
+      if (i > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("PLY face list has a vertex index which does not fit in 32 bits");
+      }
+      faceIndices.push_back(static_cast<uint32_t>(i));
+    }
+    faceStart.push_back(faceIndices.size());
+    std::vector<size_t>().swap(poly);
+  }
+  polygons.clear();
+}
+
+// Move a flat buffer of vertex indices out of happly, converting the indices to 32-bit unsigned
+template <typename S>
+void takeFaceIndices(std::vector<S>& data, std::vector<uint32_t>& faceIndices) {
+  faceIndices.resize(data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    if (static_cast<int64_t>(data[i]) < 0) {
+      throw std::runtime_error("PLY face list has a negative vertex index");
+    }
+    faceIndices[i] = static_cast<uint32_t>(data[i]);
+  }
+  std::vector<S>().swap(data);
+}
+
+// (already the right type, so no need to copy)
+void takeFaceIndices(std::vector<uint32_t>& data, std::vector<uint32_t>& faceIndices) {
+  faceIndices.clear();
+  faceIndices.swap(data);
+}
+
+// Take the face list out of a happly list property, if it holds indices of type S. happly stores list properties flat
+// (all entries in one buffer, plus the offset where each list starts), which is exactly our flat face list, so this
+// never builds a list per face. Triangle meshes need no special case: their offsets are just every third entry.
+template <typename S>
+bool takeFlatFaceList(happly::Property& prop, std::vector<uint32_t>& faceIndices, std::vector<size_t>& faceStart) {
+  happly::TypedListProperty<S>* listProp = dynamic_cast<happly::TypedListProperty<S>*>(&prop);
+  if (listProp == nullptr) return false;
+
+  takeFaceIndices(listProp->flattenedData, faceIndices);
+  faceStart.clear();
+  faceStart.swap(listProp->flattenedIndexStart);
+  return true;
+}
+
+// Read the face list of a PLY file as a flat list, with 32-bit indices. Consumes the face data in plyData.
+void readPLYFaceList(happly::PLYData& plyData, std::vector<uint32_t>& faceIndices, std::vector<size_t>& faceStart) {
+
+  // Same element and property names as happly's getFaceIndices()
+  happly::Element& faceElement = plyData.getElement("face");
+  std::string propName = faceElement.hasProperty("vertex_indices") ? "vertex_indices" : "vertex_index";
+  happly::Property& prop = *faceElement.getPropertyPtr(propName);
+
+  if (takeFlatFaceList<int32_t>(prop, faceIndices, faceStart) ||
+      takeFlatFaceList<uint32_t>(prop, faceIndices, faceStart) ||
+      takeFlatFaceList<int16_t>(prop, faceIndices, faceStart) ||
+      takeFlatFaceList<uint16_t>(prop, faceIndices, faceStart) ||
+      takeFlatFaceList<int8_t>(prop, faceIndices, faceStart) ||
+      takeFlatFaceList<uint8_t>(prop, faceIndices, faceStart)) {
+    return;
+  }
+
+  // Anything more exotic (like 64-bit indices) goes through happly's conversions
+  std::vector<std::vector<size_t>> polygons = plyData.getFaceIndices();
+  flattenFaceList(polygons, faceIndices, faceStart);
+}
+
 std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>> loadMesh_PLY(std::string filename,
                                                                                                 bool verbose) {
 
@@ -80,12 +207,14 @@ std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry
   }
 
   // Get face list
-  std::vector<std::vector<size_t>> faceIndices = plyData.getFaceIndices();
+  std::vector<uint32_t> faceIndices;
+  std::vector<size_t> faceStart;
+  readPLYFaceList(plyData, faceIndices, faceStart);
 
   stripUnusedVertices(vertexPositions, faceIndices);
 
   // === Build the mesh objects
-  return makeHalfedgeAndGeometry(faceIndices, vertexPositions, verbose);
+  return makeHalfedgeAndGeometry(faceIndices, faceStart, vertexPositions, false, verbose);
 }
 
 std::tuple<std::unique_ptr<HalfedgeMesh>, std::unique_ptr<VertexPositionGeometry>> loadMesh_OBJ(std::string filename,
@@ -152,10 +281,12 @@ std::unique_ptr<HalfedgeMesh> loadConnectivity_PLY(std::string filename, bool ve
   happly::PLYData plyData(filename);
 
   // Get face list
-  std::vector<std::vector<size_t>> faceIndices = plyData.getFaceIndices();
+  std::vector<uint32_t> faceIndices;
+  std::vector<size_t> faceStart;
+  readPLYFaceList(plyData, faceIndices, faceStart);
 
   // === Build the mesh objects
-  return std::unique_ptr<HalfedgeMesh>(new HalfedgeMesh(faceIndices, verbose));
+  return std::unique_ptr<HalfedgeMesh>(new HalfedgeMesh(faceIndices, faceStart, verbose));
 }
 
 std::unique_ptr<HalfedgeMesh> loadConnectivity_OBJ(std::string filename, bool verbose) {
@@ -35,7 +35,8 @@ void VectorHeatMethodSolver::ensureHaveScalarHeatSolver() {
 
   // Build the operator
   SparseMatrix<double> heatOp = massMat + shortTime * L;
-  scalarHeatSolver.reset(new PositiveDefiniteSolver<double>(heatOp));
+  // M + tL is strictly positive definite, so on large meshes it can use a supernodal LLt
+  scalarHeatSolver.reset(new PositiveDefiniteSolver<double>(heatOp, CholeskyMode::Auto));
 
   geom.unrequireCotanLaplacian();
 }
@@ -24,6 +24,12 @@ std::unique_ptr<VertexPositionGeometry> VertexPositionGeometry::reinterpretTo(Ha
 
 void VertexPositionGeometry::computeVertexPositions() { vertexPositions = inputVertexPositions; }
 
+void VertexPositionGeometry::updateVertexPositions(const std::vector<Vertex>& changedVertices) {
+  for (Vertex v : changedVertices) {
+    vertexPositions[v] = inputVertexPositions[v];
+  }
+}
+
 
 } // namespace surface
 } // namespace geometrycentral
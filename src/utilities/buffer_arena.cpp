@@ -0,0 +1,68 @@
+#include "geometrycentral/utilities/buffer_arena.h"
+
+namespace geometrycentral {
+
+namespace {
+thread_local BufferArena* activeArena = nullptr;
+}
+
+const size_t BufferArena::defaultMaxCachedBytes;
+
+BufferArena::BufferArena(size_t maxCachedBytes_) : nMaxCachedBytes(maxCachedBytes_), enclosing(activeArena) {
+  activeArena = this;
+}
+
+BufferArena::~BufferArena() {
+  clear();
+  activeArena = enclosing;
+}
+
+BufferArena* BufferArena::active() { return activeArena; }
+
+void* BufferArena::allocate(size_t nBytes) {
+  auto it = freeBuffers.find(nBytes);
+  if (it != freeBuffers.end() && !it->second.empty()) {
+    void* ptr = it->second.back();
+    it->second.pop_back();
+    nCachedBytes -= nBytes;
+    return ptr;
+  }
+  return Eigen::aligned_allocator<char>().allocate(nBytes);
+}
+
+void BufferArena::deallocate(void* ptr, size_t nBytes) {
+  if (nBytes > nMaxCachedBytes - nCachedBytes) {
+    Eigen::aligned_allocator<char>().deallocate(static_cast<char*>(ptr), nBytes);
+    return;
+  }
+  freeBuffers[nBytes].push_back(ptr);
+  nCachedBytes += nBytes;
+}
+
+void BufferArena::clear() {
+  for (auto& sizeAndBuffers : freeBuffers) {
+    for (void* ptr : sizeAndBuffers.second) {
+      Eigen::aligned_allocator<char>().deallocate(static_cast<char*>(ptr), sizeAndBuffers.first);
+    }
+    sizeAndBuffers.second.clear();
+  }
+  nCachedBytes = 0;
+}
+
+size_t BufferArena::cachedBytes() const { return nCachedBytes; }
+
+size_t BufferArena::maxCachedBytes() const { return nMaxCachedBytes; }
+
+void BufferArena::setMaxCachedBytes(size_t newMax) {
+  nMaxCachedBytes = newMax;
+  for (auto& sizeAndBuffers : freeBuffers) {
+    while (nCachedBytes > nMaxCachedBytes && !sizeAndBuffers.second.empty()) {
+      Eigen::aligned_allocator<char>().deallocate(static_cast<char*>(sizeAndBuffers.second.back()),
+                                                  sizeAndBuffers.first);
+      sizeAndBuffers.second.pop_back();
+      nCachedBytes -= sizeAndBuffers.first;
+    }
+  }
+}
+
+} // namespace geometrycentral
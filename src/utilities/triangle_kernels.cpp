@@ -0,0 +1,90 @@
+#include "geometrycentral/utilities/triangle_kernels.h"
+
+#include "triangle_kernels.ipp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GC_HAVE_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace geometrycentral {
+
+namespace {
+
+#ifdef GC_HAVE_SSE2_KERNELS
+// SSE2 is part of x86-64, so needs no special compiler flags or runtime check
+struct SSE2Pack {
+  typedef __m128d V;
+  static const size_t width = 2;
+  static V load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, V x) { _mm_storeu_pd(p, x); }
+  static V set1(double x) { return _mm_set1_pd(x); }
+  static V add(V a, V b) { return _mm_add_pd(a, b); }
+  static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+  static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+  static V div(V a, V b) { return _mm_div_pd(a, b); }
+  static V sqrt(V a) { return _mm_sqrt_pd(a); }
+  static V min(V a, V b) { return _mm_min_pd(a, b); }
+  static V max(V a, V b) { return _mm_max_pd(a, b); }
+};
+#endif
+
+SIMDLevel detectSIMDLevel() {
+#ifdef GC_HAVE_SIMD_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SIMDLevel::AVX512;
+  if (__builtin_cpu_supports("avx2")) return SIMDLevel::AVX2;
+#endif
+#ifdef GC_HAVE_SSE2_KERNELS
+  return SIMDLevel::SSE2;
+#else
+  return SIMDLevel::Scalar;
+#endif
+}
+
+} // namespace
+
+SIMDLevel bestSIMDLevel() {
+  static const SIMDLevel level = detectSIMDLevel();
+  return level;
+}
+
+void evaluateTriangleBatch(const TriangleBatch& batch, const TriangleBatchOutputs& outputs, SIMDLevel level) {
+
+  detail::TriangleKernelArgs args;
+  args.size = batch.size;
+  args.areas = outputs.areas;
+  for (int i = 0; i < 3; i++) {
+    for (int d = 0; d < 3; d++) {
+      args.positions[i][d] = batch.positions[i][d];
+    }
+    args.normals[i] = outputs.normals[i];
+    args.angles[i] = outputs.angles[i];
+    args.halfCotans[i] = outputs.halfCotans[i];
+  }
+
+  if (level > bestSIMDLevel()) {
+    level = bestSIMDLevel();
+  }
+
+  switch (level) {
+#ifdef GC_HAVE_SIMD_KERNELS
+  case SIMDLevel::AVX512:
+    detail::evaluateTrianglesAVX512(args);
+    break;
+  case SIMDLevel::AVX2:
+    detail::evaluateTrianglesAVX2(args);
+    break;
+#endif
+#ifdef GC_HAVE_SSE2_KERNELS
+  case SIMDLevel::SSE2:
+    evaluateTriangles<SSE2Pack>(args);
+    break;
+#endif
+  default:
+    evaluateTriangles<ScalarPack>(args);
+    break;
+  }
+}
+
+} // namespace geometrycentral
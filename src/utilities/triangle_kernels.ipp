@@ -0,0 +1,143 @@
+// Internal to the triangle kernels (see triangle_kernels.h). The kernel is written once here, against a small vector
+// type, and compiled once per instruction set in triangle_kernels*.cpp. Everything which holds code has internal
+// linkage, so that code compiled for one instruction set can never be linked into a caller compiled for another.
+
+#include <cmath>
+#include <cstddef>
+
+namespace geometrycentral {
+namespace detail {
+
+// One batch, unpacked by the dispatcher into plain arrays (no std:: templates, for the reason above)
+struct TriangleKernelArgs {
+  size_t size;
+  const double* positions[3][3];
+  double* areas;
+  double* normals[3];
+  double* angles[3];
+  double* halfCotans[3];
+};
+
+// Defined in their own translation units, which are compiled with the corresponding instruction sets enabled
+void evaluateTrianglesAVX2(const TriangleKernelArgs& args);
+void evaluateTrianglesAVX512(const TriangleKernelArgs& args);
+
+} // namespace detail
+
+namespace {
+
+// The scalar version of a vector type. Like the vector types for each instruction set, min(a, b) and max(a, b) return
+// b when either is NaN, matching the x86 instructions.
+struct ScalarPack {
+  typedef double V;
+  static const size_t width = 1;
+  static V load(const double* p) { return *p; }
+  static void store(double* p, V x) { *p = x; }
+  static V set1(double x) { return x; }
+  static V add(V a, V b) { return a + b; }
+  static V sub(V a, V b) { return a - b; }
+  static V mul(V a, V b) { return a * b; }
+  static V div(V a, V b) { return a / b; }
+  static V sqrt(V a) { return std::sqrt(a); }
+  static V min(V a, V b) { return a < b ? a : b; }
+  static V max(V a, V b) { return a > b ? a : b; }
+};
+
+// A Vector3 of packs, with the arithmetic done in exactly the same order as Vector3
+template <typename P>
+struct PackVector3 {
+  typename P::V x, y, z;
+};
+
+template <typename P>
+inline PackVector3<P> sub(const PackVector3<P>& u, const PackVector3<P>& v) {
+  return PackVector3<P>{P::sub(u.x, v.x), P::sub(u.y, v.y), P::sub(u.z, v.z)};
+}
+
+template <typename P>
+inline PackVector3<P> cross(const PackVector3<P>& u, const PackVector3<P>& v) {
+  return PackVector3<P>{P::sub(P::mul(u.y, v.z), P::mul(u.z, v.y)), P::sub(P::mul(u.z, v.x), P::mul(u.x, v.z)),
+                        P::sub(P::mul(u.x, v.y), P::mul(u.y, v.x))};
+}
+
+template <typename P>
+inline typename P::V dot(const PackVector3<P>& u, const PackVector3<P>& v) {
+  return P::add(P::add(P::mul(u.x, v.x), P::mul(u.y, v.y)), P::mul(u.z, v.z));
+}
+
+template <typename P>
+inline typename P::V norm(const PackVector3<P>& u) {
+  return P::sqrt(dot(u, u));
+}
+
+template <typename P>
+inline PackVector3<P> unit(const PackVector3<P>& u) {
+  typename P::V n = norm(u);
+  return PackVector3<P>{P::div(u.x, n), P::div(u.y, n), P::div(u.z, n)};
+}
+
+// Evaluate triangles [i, i + P::width)
+template <typename P>
+inline void evaluateTrianglePack(const detail::TriangleKernelArgs& args, size_t i) {
+  typedef typename P::V V;
+
+  PackVector3<P> p[3];
+  for (int iV = 0; iV < 3; iV++) {
+    p[iV] = PackVector3<P>{P::load(args.positions[iV][0] + i), P::load(args.positions[iV][1] + i),
+                           P::load(args.positions[iV][2] + i)};
+  }
+
+  // Areas and normals, from the cross product of the edges out of the first vertex
+  if (args.areas != nullptr || args.normals[0] != nullptr) {
+    PackVector3<P> c = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+    V n = norm(c);
+    if (args.areas != nullptr) {
+      P::store(args.areas + i, P::mul(P::set1(0.5), n));
+    }
+    if (args.normals[0] != nullptr) {
+      P::store(args.normals[0] + i, P::div(c.x, n));
+      P::store(args.normals[1] + i, P::div(c.y, n));
+      P::store(args.normals[2] + i, P::div(c.z, n));
+    }
+  }
+
+  for (int iV = 0; iV < 3; iV++) {
+    const PackVector3<P>& pI = p[iV];
+    const PackVector3<P>& pJ = p[(iV + 1) % 3];
+    const PackVector3<P>& pK = p[(iV + 2) % 3];
+
+    // Angle at pI. There is no vector arccosine, so the clamped cosines are stored and finished one at a time.
+    if (args.angles[iV] != nullptr) {
+      V q = dot(unit(sub(pJ, pI)), unit(sub(pK, pI)));
+      q = P::max(P::set1(-1.), P::min(P::set1(1.), q));
+      double* angles = args.angles[iV] + i;
+      P::store(angles, q);
+      for (size_t j = 0; j < P::width; j++) {
+        angles[j] = std::acos(angles[j]);
+      }
+    }
+
+    // Half the cotangent of the angle at pK, opposite the edge from pI to pJ
+    if (args.halfCotans[iV] != nullptr) {
+      PackVector3<P> vecR = sub(pI, pK);
+      PackVector3<P> vecL = sub(pJ, pK);
+      V cotValue = P::div(dot(vecR, vecL), norm(cross(vecR, vecL)));
+      P::store(args.halfCotans[iV] + i, P::div(cotValue, P::set1(2.)));
+    }
+  }
+}
+
+// Evaluate a whole batch, a pack at a time, finishing any remainder one triangle at a time
+template <typename P>
+void evaluateTriangles(const detail::TriangleKernelArgs& args) {
+  size_t i = 0;
+  for (; i + P::width <= args.size; i += P::width) {
+    evaluateTrianglePack<P>(args, i);
+  }
+  for (; i < args.size; i++) {
+    evaluateTrianglePack<ScalarPack>(args, i);
+  }
+}
+
+} // namespace
+} // namespace geometrycentral
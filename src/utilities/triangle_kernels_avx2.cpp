@@ -0,0 +1,37 @@
+// The triangle kernels, for AVX2. This file is compiled with -mavx2 (see src/CMakeLists.txt), and only
+// called after checking that the CPU supports it.
+
+#ifdef GC_HAVE_SIMD_KERNELS
+
+#include "triangle_kernels.ipp"
+
+#include <immintrin.h>
+
+namespace geometrycentral {
+
+namespace {
+
+struct AVX2Pack {
+  typedef __m256d V;
+  static const size_t width = 4;
+  static V load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, V x) { _mm256_storeu_pd(p, x); }
+  static V set1(double x) { return _mm256_set1_pd(x); }
+  static V add(V a, V b) { return _mm256_add_pd(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+  static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+  static V div(V a, V b) { return _mm256_div_pd(a, b); }
+  static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+  static V min(V a, V b) { return _mm256_min_pd(a, b); }
+  static V max(V a, V b) { return _mm256_max_pd(a, b); }
+};
+
+} // namespace
+
+namespace detail {
+void evaluateTrianglesAVX2(const TriangleKernelArgs& args) { evaluateTriangles<AVX2Pack>(args); }
+} // namespace detail
+
+} // namespace geometrycentral
+
+#endif
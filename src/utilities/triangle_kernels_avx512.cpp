@@ -0,0 +1,39 @@
+// The triangle kernels, for AVX512. This file is compiled with -mavx512f (see src/CMakeLists.txt), and only
+// called after checking that the CPU supports it.
+
+#ifdef GC_HAVE_SIMD_KERNELS
+
+#include "triangle_kernels.ipp"
+
+#include <immintrin.h>
+
+namespace geometrycentral {
+
+namespace {
+
+struct AVX512Pack {
+  typedef __m512d V;
+  static const size_t width = 8;
+  static V load(const double* p) { return _mm512_loadu_pd(p); }
+  static void store(double* p, V x) { _mm512_storeu_pd(p, x); }
+  static V set1(double x) { return _mm512_set1_pd(x); }
+  static V add(V a, V b) { return _mm512_add_pd(a, b); }
+  static V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+  static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+  static V div(V a, V b) { return _mm512_div_pd(a, b); }
+  // GCC 12 implements _mm512_sqrt/min/max_pd() by passing an undefined vector through a mask, which
+  // -Wmaybe-uninitialized flags. The zero-masked forms with every lane enabled are the same instructions without that.
+  static V sqrt(V a) { return _mm512_maskz_sqrt_pd(0xFF, a); }
+  static V min(V a, V b) { return _mm512_maskz_min_pd(0xFF, a, b); }
+  static V max(V a, V b) { return _mm512_maskz_max_pd(0xFF, a, b); }
+};
+
+} // namespace
+
+namespace detail {
+void evaluateTrianglesAVX512(const TriangleKernelArgs& args) { evaluateTriangles<AVX512Pack>(args); }
+} // namespace detail
+
+} // namespace geometrycentral
+
+#endif
@@ -0,0 +1,184 @@
+#include "geometrycentral/numerical/linear_solvers.h"
+#include "geometrycentral/surface/halfedge_mesh.h"
+#include "geometrycentral/surface/mesh_ordering.h"
+#include "geometrycentral/surface/vertex_position_geometry.h"
+#include "geometrycentral/utilities/timing.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+
+using namespace geometrycentral;
+using namespace geometrycentral::surface;
+using std::cout;
+using std::endl;
+
+// Benchmarks are disabled by default, since they are slow and only print results. Run them with
+//   ./bin/geometry-central-test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+// (ideally in a release build).
+
+namespace {
+
+// A triangulated N x N grid of vertices, with vertices and faces listed in random order (like many mesh files)
+struct ShuffledGrid {
+  std::unique_ptr<HalfedgeMesh> mesh;
+  std::unique_ptr<VertexPositionGeometry> geometry;
+
+  ShuffledGrid(size_t N) {
+    std::mt19937 rng(0);
+    std::vector<size_t> vLabel(N * N);
+    for (size_t i = 0; i < vLabel.size(); i++) vLabel[i] = i;
+    std::shuffle(vLabel.begin(), vLabel.end(), rng);
+
+    std::vector<std::array<size_t, 3>> triangles;
+    for (size_t i = 0; i + 1 < N; i++) {
+      for (size_t j = 0; j + 1 < N; j++) {
+        size_t v00 = vLabel[i * N + j], v10 = vLabel[(i + 1) * N + j];
+        size_t v01 = vLabel[i * N + j + 1], v11 = vLabel[(i + 1) * N + j + 1];
+        triangles.push_back({{v00, v10, v11}});
+        triangles.push_back({{v00, v11, v01}});
+      }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+
+    mesh.reset(new HalfedgeMesh(triangles));
+    geometry.reset(new VertexPositionGeometry(*mesh));
+    for (size_t i = 0; i < N; i++) {
+      for (size_t j = 0; j < N; j++) {
+        geometry->inputVertexPositions[mesh->vertex(vLabel[i * N + j])] = Vector3{double(i), double(j), 0.};
+      }
+    }
+  }
+};
+
+// Time some typical traversals and matrix operations on the mesh
+void runLocalityBenchmark(ShuffledGrid& grid, std::string name) {
+  HalfedgeMesh& mesh = *grid.mesh;
+  VertexPositionGeometry& geometry = *grid.geometry;
+  const int nRep = 10;
+
+  // Gather over faces
+  double areaSum = 0.;
+  START_TIMING(faces)
+  for (int iRep = 0; iRep < nRep; iRep++) {
+    for (Face f : mesh.faces()) {
+      areaSum += geometry.faceArea(f);
+    }
+  }
+  long long faceTime = FINISH_TIMING(faces) / nRep;
+
+  // Gather over vertex neighborhoods
+  Vector3 neighborSum = Vector3::zero();
+  START_TIMING(vertices)
+  for (int iRep = 0; iRep < nRep; iRep++) {
+    for (Vertex v : mesh.vertices()) {
+      for (Vertex vn : v.adjacentVertices()) {
+        neighborSum += geometry.inputVertexPositions[vn];
+      }
+    }
+  }
+  long long vertexTime = FINISH_TIMING(vertices) / nRep;
+
+  // Build the Laplacian
+  START_TIMING(laplacian)
+  geometry.requireCotanLaplacian();
+  long long laplacianTime = FINISH_TIMING(laplacian);
+
+  // Bandwidth and envelope of the Laplacian. The envelope bounds the fill of a factorization without a fill-reducing
+  // permutation, and both measure how far apart neighboring entries are in memory.
+  size_t bandwidth = 0;
+  size_t envelope = 0;
+  SparseMatrix<double> L = geometry.cotanLaplacian + 1e-6 * identityMatrix<double>(mesh.nVertices());
+  for (int iCol = 0; iCol < L.outerSize(); iCol++) {
+    size_t minRow = iCol;
+    for (SparseMatrix<double>::InnerIterator it(L, iCol); it; ++it) {
+      minRow = std::min(minRow, static_cast<size_t>(it.row()));
+    }
+    bandwidth = std::max(bandwidth, iCol - minRow);
+    envelope += iCol - minRow;
+  }
+  geometry.unrequireCotanLaplacian();
+
+  // Factor and solve with the usual solver (which applies its own fill-reducing ordering)
+  Vector<double> rhs = Vector<double>::Ones(mesh.nVertices());
+  START_TIMING(solve)
+  PositiveDefiniteSolver<double> solver(L);
+  Vector<double> x = solver.solve(rhs);
+  long long solveTime = FINISH_TIMING(solve);
+
+  cout << "  " << name << ": face loop " << faceTime << " us, vertex loop " << vertexTime << " us, Laplacian "
+       << laplacianTime << " us, factor+solve " << solveTime << " us, bandwidth " << bandwidth << ", envelope "
+       << envelope << "   (" << areaSum << ", " << neighborSum << ", " << x.sum() << ")" << endl;
+}
+
+// Solve for many right hand sides against one factorization, one at a time and all at once
+template <typename S>
+void runMultipleRHSBenchmark(S& solver, const DenseMatrix<double>& rhs, std::string name) {
+  START_TIMING(looped)
+  DenseMatrix<double> xLooped(rhs.rows(), rhs.cols());
+  for (long int j = 0; j < rhs.cols(); j++) {
+    xLooped.col(j) = solver.solve(Vector<double>(rhs.col(j)));
+  }
+  long long loopedTime = FINISH_TIMING(looped);
+
+  START_TIMING(blocked)
+  DenseMatrix<double> xBlocked;
+  solver.solve(xBlocked, rhs);
+  long long blockedTime = FINISH_TIMING(blocked);
+
+  cout << "  " << name << ": " << rhs.cols() << " right hand sides, looped " << loopedTime << " us, blocked "
+       << blockedTime << " us   (difference " << (xLooped - xBlocked).norm() << ")" << endl;
+}
+
+} // namespace
+
+TEST(BenchmarkTest, DISABLED_MultipleRHSBenchmark) {
+#ifdef GC_HAVE_SUITESPARSE
+  cout << "backend: Suitesparse" << endl;
+#else
+  cout << "backend: Eigen" << endl;
+#endif
+  for (size_t N : {300, 1000}) {
+    cout << "grid with " << N * N << " vertices:" << endl;
+    ShuffledGrid grid(N);
+    grid.geometry->requireCotanLaplacian();
+    grid.geometry->requireVertexLumpedMassMatrix();
+    SparseMatrix<double> heatOp = grid.geometry->vertexLumpedMassMatrix + 1e-2 * grid.geometry->cotanLaplacian;
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    for (long int nRHS : {16, 128}) {
+      DenseMatrix<double> rhs(heatOp.rows(), nRHS);
+      for (long int j = 0; j < nRHS; j++) {
+        for (long int i = 0; i < rhs.rows(); i++) {
+          rhs(i, j) = dist(rng);
+        }
+      }
+
+      // The blocked solve is where a supernodal factorization pays off (BLAS-3 over each supernode), so time both
+      // kinds. The Eigen fallback ignores the mode, so the two lines are the same there.
+      PositiveDefiniteSolver<double> ldltSolver(heatOp, CholeskyMode::SimplicialLDLT);
+      runMultipleRHSBenchmark(ldltSolver, rhs, "positive definite (simplicial LDLT)");
+      PositiveDefiniteSolver<double> lltSolver(heatOp, CholeskyMode::SupernodalLLT);
+      runMultipleRHSBenchmark(lltSolver, rhs, "positive definite (supernodal LLT)");
+      SquareSolver<double> squareSolver(heatOp);
+      runMultipleRHSBenchmark(squareSolver, rhs, "square");
+    }
+  }
+}
+
+TEST(BenchmarkTest, DISABLED_LocalityReorderingBenchmark) {
+  for (size_t N : {300, 1000}) {
+    cout << "grid with " << N * N << " vertices:" << endl;
+    for (std::string name : {"shuffled", "morton", "rcm"}) {
+      ShuffledGrid grid(N);
+      if (name == "morton") reorderForLocality(*grid.geometry, MeshOrdering::SpaceFillingCurve);
+      if (name == "rcm") reorderForLocality(*grid.geometry, MeshOrdering::ReverseCuthillMcKee);
+      runLocalityBenchmark(grid, name);
+    }
+  }
+}
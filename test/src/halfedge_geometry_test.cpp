@@ -7,15 +7,20 @@
 #include "geometrycentral/surface/embedded_geometry_interface.h"
 #include "geometrycentral/surface/extrinsic_geometry_interface.h"
 #include "geometrycentral/surface/intrinsic_geometry_interface.h"
+#include "geometrycentral/surface/mesh_ordering.h"
 #include "geometrycentral/surface/surface_point.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
+#include "geometrycentral/utilities/triangle_kernels.h"
 
 #include "load_test_meshes.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 
@@ -51,6 +56,62 @@ TEST_F(HalfedgeGeometrySuite, GeometryPointers) {
   { std::unique_ptr<EmbeddedGeometryInterface> deleteGeom(getAsset("bob_small.ply").geometry.release()); }
 }
 
+// ============================================================
+// =============== Element ordering tests
+// ============================================================
+
+TEST_F(HalfedgeGeometrySuite, ReorderForLocalityTest) {
+  for (MeshOrdering ordering : {MeshOrdering::SpaceFillingCurve, MeshOrdering::ReverseCuthillMcKee}) {
+    for (MeshAsset& a : triangularMeshes()) {
+      a.printThyName();
+      HalfedgeMesh& mesh = *a.mesh;
+      VertexPositionGeometry& geometry = *a.geometry;
+
+      geometry.requireFaceAreas();
+      geometry.requireVertexIndices();
+      FaceData<double> origAreas = geometry.faceAreas;
+
+      reorderForLocality(geometry, ordering);
+      mesh.validateConnectivity();
+
+      // Required quantities were recomputed in the new order, and match the old data which was permuted along
+      for (Face f : mesh.faces()) {
+        EXPECT_NEAR(geometry.faceAreas[f], origAreas[f], 1e-9);
+      }
+      for (Vertex v : mesh.vertices()) {
+        EXPECT_EQ(geometry.vertexIndices[v], v.getIndex());
+      }
+    }
+  }
+}
+
+// On a shuffled mesh, reverse Cuthill-McKee should reduce the bandwidth of the Laplacian
+TEST_F(HalfedgeGeometrySuite, ReverseCuthillMcKeeBandwidthTest) {
+  auto asset = getAsset("spot.ply");
+  HalfedgeMesh& mesh = *asset.mesh;
+
+  auto bandwidth = [&]() {
+    size_t maxDiff = 0;
+    for (Edge e : mesh.edges()) {
+      size_t iA = e.halfedge().vertex().getIndex();
+      size_t iB = e.halfedge().twin().vertex().getIndex();
+      maxDiff = std::max(maxDiff, iA > iB ? iA - iB : iB - iA);
+    }
+    return maxDiff;
+  };
+
+  std::vector<size_t> shuffle(mesh.nVertices());
+  for (size_t i = 0; i < shuffle.size(); i++) shuffle[i] = i;
+  std::mt19937 rng(0);
+  std::shuffle(shuffle.begin(), shuffle.end(), rng);
+  mesh.permuteVertices(shuffle);
+  size_t shuffledBandwidth = bandwidth();
+
+  applyVertexOrder(mesh, reverseCuthillMcKeeVertexOrder(mesh));
+  mesh.validateConnectivity();
+  EXPECT_LT(bandwidth(), shuffledBandwidth / 4);
+}
+
 // ============================================================
 // =============== Quantity management tests
 // ============================================================
@@ -177,6 +238,437 @@ TEST_F(HalfedgeGeometrySuite, PurgeTestDEC) {
 }
 
 
+// Many threads requiring the same quantities compute each of them once, and all see the finished result
+TEST_F(HalfedgeGeometrySuite, ConcurrentRequireTest) {
+  auto asset = getAsset("bob_small.ply");
+  HalfedgeMesh& mesh = *asset.mesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Reference values, from a separate geometry
+  std::unique_ptr<VertexPositionGeometry> reference = geometry.copy();
+  reference->requireCotanLaplacian();
+  reference->requireVertexDualAreas();
+
+  mesh.freeze();
+  std::vector<double> laplacianSums(8);
+  std::vector<double> areaSums(8);
+  std::vector<std::thread> threads;
+  for (size_t iThread = 0; iThread < laplacianSums.size(); iThread++) {
+    threads.emplace_back([&, iThread]() {
+      if (iThread % 2 == 0) geometry.requireVertexDualAreas();
+      geometry.requireCotanLaplacian();
+      if (iThread % 2 == 1) geometry.requireVertexDualAreas();
+      laplacianSums[iThread] = geometry.cotanLaplacian.cwiseAbs().sum();
+      areaSums[iThread] = geometry.vertexDualAreas.toVector().sum();
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (size_t iThread = 0; iThread < laplacianSums.size(); iThread++) {
+    EXPECT_EQ(laplacianSums[iThread], reference->cotanLaplacian.cwiseAbs().sum());
+    EXPECT_EQ(areaSums[iThread], reference->vertexDualAreas.toVector().sum());
+  }
+  for (size_t iThread = 0; iThread < laplacianSums.size(); iThread++) {
+    geometry.unrequireCotanLaplacian();
+    geometry.unrequireVertexDualAreas();
+  }
+  EXPECT_THROW(geometry.unrequireVertexDualAreas(), std::logic_error);
+
+  // Quantities computed while frozen are containers on the frozen mesh, so must be cleared out before unfreezing
+  EXPECT_THROW(mesh.unfreeze(), std::runtime_error);
+  geometry.purgeQuantities();
+  mesh.unfreeze();
+}
+
+// Stale quantities from before the mesh was frozen are recomputed into containers which are registered with the mesh,
+// while others are created on the frozen mesh; both may happen on many threads at once
+TEST_F(HalfedgeGeometrySuite, ConcurrentRefreshTest) {
+  auto asset = getAsset("bob_small.ply");
+  HalfedgeMesh& mesh = *asset.mesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Compute some quantities before freezing, then leave them stale
+  geometry.requireFaceAreas();
+  geometry.requireFaceNormals();
+  geometry.requireVertexDualAreas();
+  geometry.requireVertexIndices();
+  geometry.requireFaceIndices();
+  geometry.requireCotanLaplacian();
+  geometry.unrequireFaceAreas();
+  geometry.unrequireFaceNormals();
+  geometry.unrequireVertexDualAreas();
+  geometry.unrequireVertexIndices();
+  geometry.unrequireFaceIndices();
+  geometry.unrequireCotanLaplacian();
+  geometry.requireEdgeLengths();
+  geometry.inputVertexPositions[mesh.vertex(0)] += Vector3{0.01, 0.02, 0.03};
+  geometry.refreshQuantities();
+
+  std::unique_ptr<VertexPositionGeometry> reference = geometry.copy();
+  reference->requireFaceAreas();
+  reference->requireVertexDualAreas();
+  reference->requireVertexNormals();
+  reference->requireCotanLaplacian();
+
+  // Each thread requires the same quantities, starting at a different one
+  std::vector<std::function<void()>> requireFuncs = {
+      [&]() { geometry.requireFaceAreas(); },        [&]() { geometry.requireFaceNormals(); },
+      [&]() { geometry.requireVertexDualAreas(); },  [&]() { geometry.requireVertexIndices(); },
+      [&]() { geometry.requireFaceIndices(); },      [&]() { geometry.requireCotanLaplacian(); },
+      [&]() { geometry.requireVertexNormals(); },    [&]() { geometry.requireEdgeLengths(); }};
+  mesh.freeze();
+  std::vector<std::thread> threads;
+  for (size_t iThread = 0; iThread < 8; iThread++) {
+    threads.emplace_back([&, iThread]() {
+      for (size_t i = 0; i < requireFuncs.size(); i++) {
+        requireFuncs[(i + iThread) % requireFuncs.size()]();
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (Face f : mesh.faces()) {
+    EXPECT_EQ(geometry.faceAreas[f], reference->faceAreas[f]);
+  }
+  for (Vertex v : mesh.vertices()) {
+    EXPECT_EQ(geometry.vertexDualAreas[v], reference->vertexDualAreas[v]);
+    EXPECT_EQ(geometry.vertexNormals[v], reference->vertexNormals[v]);
+  }
+  EXPECT_EQ((geometry.cotanLaplacian - reference->cotanLaplacian).norm(), 0.);
+
+  // The vertex normals were computed on the frozen mesh, and are still required. Thawing registers them with the mesh,
+  // so it can be unfrozen and mutated with them kept up to date.
+  EXPECT_THROW(mesh.unfreeze(), std::runtime_error);
+  geometry.thawQuantities();
+  mesh.unfreeze();
+  mesh.insertVertexAlongEdge(mesh.edge(0));
+  EXPECT_EQ(geometry.vertexNormals.size(), mesh.nVertices());
+  EXPECT_EQ(geometry.vertexDualAreas.size(), mesh.nVertices());
+}
+
+
+TEST_F(HalfedgeGeometrySuite, RequireAllTest) {
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    VertexPositionGeometry& geometry = *a.geometry;
+    std::unique_ptr<VertexPositionGeometry> reference = geometry.copy();
+
+    geometry.requireAll({[&]() { geometry.requireEdgeLengths(); }, [&]() { geometry.requireFaceAreas(); },
+                         [&]() { geometry.requireCornerAngles(); }, [&]() { geometry.requireEdgeCotanWeights(); },
+                         [&]() { geometry.requireVertexDualAreas(); }, [&]() { geometry.requireVertexNormals(); },
+                         [&]() { geometry.requireCotanLaplacian(); }},
+                        4);
+
+    reference->requireEdgeCotanWeights();
+    reference->requireVertexNormals();
+    reference->requireCotanLaplacian();
+    for (Edge e : a.mesh->edges()) {
+      EXPECT_EQ(geometry.edgeCotanWeights[e], reference->edgeCotanWeights[e]);
+    }
+    for (Vertex v : a.mesh->vertices()) {
+      EXPECT_EQ(geometry.vertexNormals[v], reference->vertexNormals[v]);
+    }
+    EXPECT_EQ((geometry.cotanLaplacian - reference->cotanLaplacian).norm(), 0.);
+
+    // Calls may be nested, and the mesh goes back to registering without locking afterwards
+    std::unique_ptr<VertexPositionGeometry> nested = reference->copy();
+    geometry.requireAll({[&]() { nested->requireAll({[&]() { nested->requireFaceNormals(); },
+                                                     [&]() { nested->requireVertexGaussianCurvatures(); }},
+                                                    2); },
+                         [&]() { geometry.requireFaceNormals(); }, [&]() { nested->requireEdgeDihedralAngles(); }},
+                        3);
+    EXPECT_EQ(a.mesh->sharedCallbackCount.load(), 0u);
+
+    // The quantities are registered with the mesh as usual
+    a.mesh->insertVertexAlongEdge(a.mesh->edge(0));
+    EXPECT_EQ(geometry.vertexDualAreas.size(), a.mesh->nVertices());
+    EXPECT_EQ(nested->faceNormals.size(), a.mesh->nFaces());
+  }
+}
+
+
+TEST_F(HalfedgeGeometrySuite, MarkVerticesChangedTest) {
+  size_t nUntouched = 0;
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexPositionGeometry& geometry = *a.geometry;
+
+    geometry.requireEdgeLengths();
+    geometry.requireVertexDualAreas();
+    geometry.requireVertexAngleSums();
+    geometry.requireHalfedgeCotanWeights();
+    geometry.requireVertexNormals();
+    geometry.requireCotanLaplacian();
+    geometry.requireVertexLumpedMassMatrix();
+    geometry.requireVertexGaussianCurvatures(); // not updated locally
+    Eigen::SparseMatrix<double> L = geometry.cotanLaplacian;
+    const double* laplacianValues = geometry.cotanLaplacian.valuePtr();
+
+    // Move a few vertices
+    std::vector<Vertex> moved;
+    for (size_t iV = 0; iV < mesh.nVertices(); iV += 7) {
+      moved.push_back(mesh.vertex(iV));
+      geometry.inputVertexPositions[mesh.vertex(iV)] += Vector3{0.01, -0.02, 0.03} * (iV % 3);
+    }
+    geometry.markVerticesChanged(moved);
+
+    std::unique_ptr<VertexPositionGeometry> reference = geometry.copy();
+    reference->requireEdgeLengths();
+    reference->requireVertexDualAreas();
+    reference->requireVertexAngleSums();
+    reference->requireHalfedgeCotanWeights();
+    reference->requireVertexNormals();
+    reference->requireCotanLaplacian();
+    reference->requireVertexLumpedMassMatrix();
+    reference->requireVertexGaussianCurvatures();
+
+    for (Edge e : mesh.edges()) {
+      EXPECT_EQ(geometry.edgeLengths[e], reference->edgeLengths[e]);
+      EXPECT_EQ(geometry.edgeCotanWeights[e], reference->edgeCotanWeights[e]);
+    }
+    for (Halfedge he : mesh.halfedges()) {
+      EXPECT_EQ(geometry.halfedgeCotanWeights[he], reference->halfedgeCotanWeights[he]);
+    }
+    for (Face f : mesh.faces()) {
+      EXPECT_EQ(geometry.faceAreas[f], reference->faceAreas[f]);
+      EXPECT_EQ(geometry.faceNormals[f], reference->faceNormals[f]);
+    }
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_NEAR(geometry.vertexDualAreas[v], reference->vertexDualAreas[v], 1e-12);
+      EXPECT_NEAR(geometry.vertexAngleSums[v], reference->vertexAngleSums[v], 1e-12);
+      EXPECT_NEAR(geometry.vertexGaussianCurvatures[v], reference->vertexGaussianCurvatures[v], 1e-12);
+      EXPECT_LT(norm(geometry.vertexNormals[v] - reference->vertexNormals[v]), 1e-12);
+    }
+    EXPECT_LT((geometry.cotanLaplacian - reference->cotanLaplacian).norm(), 1e-9);
+    EXPECT_LT((geometry.vertexLumpedMassMatrix - reference->vertexLumpedMassMatrix).norm(), 1e-12);
+
+    // The Laplacian was patched in place, rather than rebuilt: same storage, same pattern, and the columns of vertices
+    // away from the moved ones are untouched
+    const Eigen::SparseMatrix<double>& newL = geometry.cotanLaplacian;
+    EXPECT_EQ(newL.valuePtr(), laplacianValues);
+    ASSERT_EQ(newL.nonZeros(), L.nonZeros());
+    EXPECT_TRUE(std::equal(L.outerIndexPtr(), L.outerIndexPtr() + L.outerSize() + 1, newL.outerIndexPtr()));
+    EXPECT_TRUE(std::equal(L.innerIndexPtr(), L.innerIndexPtr() + L.nonZeros(), newL.innerIndexPtr()));
+    VertexData<char> nearMoved(mesh, false);
+    for (Vertex v : moved) {
+      nearMoved[v] = true;
+      for (Vertex vn : v.adjacentVertices()) nearMoved[vn] = true;
+    }
+    for (Vertex v : mesh.vertices()) {
+      if (nearMoved[v]) continue;
+      size_t iCol = v.getIndex();
+      for (int k = L.outerIndexPtr()[iCol]; k < L.outerIndexPtr()[iCol + 1]; k++) {
+        EXPECT_EQ(newL.valuePtr()[k], L.valuePtr()[k]);
+      }
+      nUntouched++;
+    }
+  }
+  EXPECT_GT(nUntouched, 0u);
+}
+
+
+// The vertex operators are assembled directly from the connectivity; check them against a triplet assembly, and check
+// that refreshing them rewrites the values in place
+TEST_F(HalfedgeGeometrySuite, VertexOperatorAssemblyTest) {
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexPositionGeometry& geometry = *a.geometry;
+
+    geometry.requireVertexIndices();
+    geometry.requireEdgeCotanWeights();
+    geometry.requireCotanLaplacian();
+    geometry.requireVertexGalerkinMassMatrix();
+    geometry.requireFaceAreas();
+    geometry.requireTransportVectorsAlongHalfedge();
+    geometry.requireVertexConnectionLaplacian();
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (Edge e : mesh.edges()) {
+      size_t iVTail = geometry.vertexIndices[e.halfedge().vertex()];
+      size_t iVHead = geometry.vertexIndices[e.halfedge().twin().vertex()];
+      double weight = geometry.edgeCotanWeights[e];
+      triplets.emplace_back(iVTail, iVTail, weight);
+      triplets.emplace_back(iVHead, iVHead, weight);
+      triplets.emplace_back(iVTail, iVHead, -weight);
+      triplets.emplace_back(iVHead, iVTail, -weight);
+    }
+    Eigen::SparseMatrix<double> L(mesh.nVertices(), mesh.nVertices());
+    L.setFromTriplets(triplets.begin(), triplets.end());
+    EXPECT_LT((geometry.cotanLaplacian - L).norm(), 1e-9);
+    EXPECT_EQ(geometry.cotanLaplacian.nonZeros(), L.nonZeros());
+
+    std::vector<Eigen::Triplet<double>> massTriplets;
+    for (Face f : mesh.faces()) {
+      double area = geometry.faceAreas[f];
+      size_t iV[3] = {geometry.vertexIndices[f.halfedge().vertex()],
+                      geometry.vertexIndices[f.halfedge().next().vertex()],
+                      geometry.vertexIndices[f.halfedge().next().next().vertex()]};
+      for (size_t j = 0; j < 3; j++) {
+        massTriplets.emplace_back(iV[j], iV[j], area / 6.);
+        massTriplets.emplace_back(iV[j], iV[(j + 1) % 3], area / 12.);
+        massTriplets.emplace_back(iV[j], iV[(j + 2) % 3], area / 12.);
+      }
+    }
+    Eigen::SparseMatrix<double> M(mesh.nVertices(), mesh.nVertices());
+    M.setFromTriplets(massTriplets.begin(), massTriplets.end());
+    EXPECT_LT((geometry.vertexGalerkinMassMatrix - M).norm(), 1e-12);
+    EXPECT_EQ(geometry.vertexGalerkinMassMatrix.nonZeros(), M.nonZeros());
+    EXPECT_LT((Eigen::SparseMatrix<double>(M.transpose()) - M).norm(), 1e-12);
+
+    std::vector<Eigen::Triplet<std::complex<double>>> connTriplets;
+    for (Halfedge he : mesh.halfedges()) {
+      size_t iTail = geometry.vertexIndices[he.vertex()];
+      size_t iTip = geometry.vertexIndices[he.twin().vertex()];
+      double weight = geometry.edgeCotanWeights[he.edge()];
+      Vector2 rot = geometry.transportVectorsAlongHalfedge[he.twin()];
+      connTriplets.emplace_back(iTail, iTail, weight);
+      connTriplets.emplace_back(iTail, iTip, std::complex<double>(-weight * rot));
+    }
+    Eigen::SparseMatrix<std::complex<double>> Lconn(mesh.nVertices(), mesh.nVertices());
+    Lconn.setFromTriplets(connTriplets.begin(), connTriplets.end());
+    EXPECT_LT((geometry.vertexConnectionLaplacian - Lconn).norm(), 1e-9);
+    EXPECT_EQ(geometry.vertexConnectionLaplacian.nonZeros(), Lconn.nonZeros());
+
+    // Refresh after moving the vertices; the matrices keep their buffers
+    const double* lValues = geometry.cotanLaplacian.valuePtr();
+    const double* mValues = geometry.vertexGalerkinMassMatrix.valuePtr();
+    for (Vertex v : mesh.vertices()) {
+      geometry.inputVertexPositions[v] *= 2.;
+    }
+    geometry.refreshQuantities();
+    EXPECT_EQ(geometry.cotanLaplacian.valuePtr(), lValues);
+    EXPECT_EQ(geometry.vertexGalerkinMassMatrix.valuePtr(), mValues);
+    EXPECT_LT((geometry.cotanLaplacian - L).norm(), 1e-9); // cotan weights are scale-invariant
+    EXPECT_LT((geometry.vertexGalerkinMassMatrix - 4. * M).norm(), 1e-9);
+  }
+}
+
+
+TEST_F(HalfedgeGeometrySuite, TriangleQuantitiesTest) {
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexPositionGeometry& geometry = *a.geometry;
+    geometry.requireEdgeLengths();
+    EdgeLengthGeometry intrinsicGeometry(mesh, geometry.edgeLengths);
+
+    // Computed in one pass, or one quantity at a time
+    std::unique_ptr<VertexPositionGeometry> fusedGeometry = geometry.copy();
+    std::unique_ptr<EdgeLengthGeometry> fusedIntrinsicGeometry = intrinsicGeometry.copy();
+    std::vector<IntrinsicGeometryInterface*> fused{fusedGeometry.get(), fusedIntrinsicGeometry.get()};
+    std::vector<IntrinsicGeometryInterface*> separate{&geometry, &intrinsicGeometry};
+    for (size_t i = 0; i < 2; i++) {
+      fused[i]->requireTriangleQuantities();
+      separate[i]->requireFaceAreas();
+      separate[i]->requireVertexDualAreas();
+      separate[i]->requireCornerAngles();
+      separate[i]->requireHalfedgeCotanWeights();
+      separate[i]->requireEdgeCotanWeights();
+
+      for (Face f : mesh.faces()) {
+        EXPECT_EQ(fused[i]->faceAreas[f], separate[i]->faceAreas[f]);
+      }
+      for (Vertex v : mesh.vertices()) {
+        EXPECT_EQ(fused[i]->vertexDualAreas[v], separate[i]->vertexDualAreas[v]);
+      }
+      for (Corner c : mesh.corners()) {
+        EXPECT_EQ(fused[i]->cornerAngles[c], separate[i]->cornerAngles[c]);
+      }
+      for (Halfedge he : mesh.halfedges()) {
+        EXPECT_EQ(fused[i]->halfedgeCotanWeights[he], separate[i]->halfedgeCotanWeights[he]);
+      }
+      for (Edge e : mesh.edges()) {
+        EXPECT_EQ(fused[i]->edgeCotanWeights[e], separate[i]->edgeCotanWeights[e]);
+      }
+
+      // Still populated after a refresh, and cleared once no longer required
+      fused[i]->refreshQuantities();
+      EXPECT_EQ(fused[i]->edgeCotanWeights.size(), mesh.nEdges());
+      fused[i]->unrequireTriangleQuantities();
+      fused[i]->purgeQuantities();
+      EXPECT_EQ(fused[i]->edgeCotanWeights.size(), 0u);
+      EXPECT_THROW(fused[i]->unrequireTriangleQuantities(), std::logic_error);
+    }
+  }
+}
+
+
+TEST_F(HalfedgeGeometrySuite, TriangleKernelsTest) {
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexPositionGeometry& geometry = *a.geometry;
+
+    // Gather the triangles, plus a degenerate one at the end
+    size_t nTri = mesh.nFaces() + 1;
+    std::vector<std::vector<double>> positions(9, std::vector<double>(nTri, 0.));
+    size_t iF = 0;
+    for (Face f : mesh.faces()) {
+      Halfedge he = f.halfedge();
+      for (int i = 0; i < 3; i++) {
+        for (int d = 0; d < 3; d++) {
+          positions[3 * i + d][iF] = geometry.inputVertexPositions[he.vertex()][d];
+        }
+        he = he.next();
+      }
+      iF++;
+    }
+    TriangleBatch batch;
+    batch.size = nTri;
+    for (int i = 0; i < 3; i++) {
+      for (int d = 0; d < 3; d++) {
+        batch.positions[i][d] = positions[3 * i + d].data();
+      }
+    }
+
+    // Evaluate at every level
+    std::vector<std::vector<std::vector<double>>> results;
+    for (int level = 0; level <= static_cast<int>(SIMDLevel::AVX512); level++) {
+      results.emplace_back(10, std::vector<double>(nTri));
+      std::vector<std::vector<double>>& r = results.back();
+      TriangleBatchOutputs outputs;
+      outputs.areas = r[0].data();
+      for (int i = 0; i < 3; i++) {
+        outputs.normals[i] = r[1 + i].data();
+        outputs.angles[i] = r[4 + i].data();
+        outputs.halfCotans[i] = r[7 + i].data();
+      }
+      evaluateTriangleBatch(batch, outputs, static_cast<SIMDLevel>(level));
+    }
+
+    // The vector instructions do exactly the same arithmetic as the scalar version
+    for (size_t level = 1; level < results.size(); level++) {
+      for (size_t k = 0; k < 10; k++) {
+        for (size_t iT = 0; iT < nTri; iT++) {
+          double scalar = results[0][k][iT];
+          double vector = results[level][k][iT];
+          EXPECT_TRUE(scalar == vector || (std::isnan(scalar) && std::isnan(vector)));
+        }
+      }
+    }
+
+    // ...which is that of the usual computations
+    iF = 0;
+    for (Face f : mesh.faces()) {
+      EXPECT_NEAR(results[0][0][iF], geometry.faceArea(f), 1e-12);
+      Vector3 N{results[0][1][iF], results[0][2][iF], results[0][3][iF]};
+      EXPECT_LT(norm(N - geometry.faceNormal(f)), 1e-12);
+      Halfedge he = f.halfedge();
+      for (int i = 0; i < 3; i++) {
+        EXPECT_NEAR(results[0][4 + i][iF], geometry.cornerAngle(he.corner()), 1e-12);
+        EXPECT_NEAR(results[0][7 + i][iF], geometry.halfedgeCotanWeight(he), 1e-9);
+        he = he.next();
+      }
+      iF++;
+    }
+  }
+}
+
+
 // Copying
 TEST_F(HalfedgeGeometrySuite, CopyTest) {
   auto asset = getAsset("bob_small.ply");
@@ -1,13 +1,18 @@
 
+#include "geometrycentral/surface/compact_triangle_mesh.h"
+#include "geometrycentral/surface/halfedge_column_containers.h"
 #include "geometrycentral/surface/halfedge_mesh.h"
 #include "geometrycentral/surface/meshio.h"
+#include "geometrycentral/utilities/buffer_arena.h"
 
 #include "load_test_meshes.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 
@@ -36,6 +41,312 @@ TEST_F(HalfedgeMeshSuite, ValidateBoundaryMeshTest) {
   }
 }
 
+// ============================================================
+// =============== Construction tests
+// ============================================================
+
+// Edges are numbered in the order they are first seen in the face list, and the first halfedge seen gets the even index
+TEST_F(HalfedgeMeshSuite, ConstructionOrderingTest) {
+  std::vector<std::vector<size_t>> polygons{{0, 1, 2}, {0, 2, 3}};
+  HalfedgeMesh mesh(polygons);
+
+  ASSERT_EQ(mesh.nHalfedges(), 10);
+  ASSERT_EQ(mesh.nBoundaryLoops(), 1);
+
+  std::vector<size_t> expectedTail{0, 1, 1, 2, 2, 0, 2, 3, 3, 0};
+  std::vector<size_t> expectedFace{0, 2, 0, 2, 0, 1, 1, 2, 1, 2};
+  for (size_t iHe = 0; iHe < mesh.nHalfedges(); iHe++) {
+    Halfedge he = mesh.halfedge(iHe);
+    EXPECT_EQ(he.vertex().getIndex(), expectedTail[iHe]);
+    if (he.isInterior()) {
+      EXPECT_EQ(he.face().getIndex(), expectedFace[iHe]);
+    } else {
+      EXPECT_EQ(expectedFace[iHe], 2);
+    }
+  }
+
+  EXPECT_EQ(mesh.face(0).halfedge().getIndex(), 0);
+  EXPECT_EQ(mesh.face(1).halfedge().getIndex(), 5);
+  EXPECT_EQ(mesh.halfedge(5).next().getIndex(), 6);
+  EXPECT_EQ(mesh.halfedge(8).next().getIndex(), 5);
+}
+
+namespace {
+// Triangulated n x n grid, with the quads for which removeQuad(i, j) is true left out
+template <typename R>
+std::vector<std::vector<size_t>> holeyGridPolygons(size_t n, R removeQuad) {
+  std::vector<std::vector<size_t>> polygons;
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      if (removeQuad(i, j)) continue;
+      size_t a = i * (n + 1) + j;
+      size_t b = a + 1;
+      size_t c = a + n + 2;
+      size_t d = a + n + 1;
+      polygons.push_back({a, b, c});
+      polygons.push_back({a, c, d});
+    }
+  }
+  return polygons;
+}
+} // namespace
+
+TEST_F(HalfedgeMeshSuite, ConstructionParallelTest) {
+  std::vector<std::vector<std::vector<size_t>>> polygonLists;
+  for (MeshAsset& a : allMeshes()) {
+    polygonLists.push_back(a.mesh->getFaceVertexList());
+  }
+
+  // The test meshes are too small to be split between threads, so also use a large grid with many holes (and so many
+  // boundary loops)
+  polygonLists.push_back(holeyGridPolygons(200, [](size_t i, size_t j) { return i % 10 == 5 && j % 10 == 5; }));
+
+  for (const std::vector<std::vector<size_t>>& polygons : polygonLists) {
+    HalfedgeMesh serialMesh(polygons);
+    for (size_t nThreads : {2, 3, 8}) {
+      HalfedgeMesh parallelMesh(polygons, false, nThreads);
+      parallelMesh.validateConnectivity();
+
+      ASSERT_EQ(parallelMesh.nHalfedges(), serialMesh.nHalfedges());
+      ASSERT_EQ(parallelMesh.nBoundaryLoops(), serialMesh.nBoundaryLoops());
+      for (size_t iHe = 0; iHe < serialMesh.nHalfedges(); iHe++) {
+        EXPECT_EQ(parallelMesh.halfedge(iHe).next().getIndex(), serialMesh.halfedge(iHe).next().getIndex());
+        EXPECT_EQ(parallelMesh.halfedge(iHe).vertex().getIndex(), serialMesh.halfedge(iHe).vertex().getIndex());
+      }
+      for (size_t iV = 0; iV < serialMesh.nVertices(); iV++) {
+        EXPECT_EQ(parallelMesh.vertex(iV).halfedge().getIndex(), serialMesh.vertex(iV).halfedge().getIndex());
+      }
+      for (size_t iB = 0; iB < serialMesh.nBoundaryLoops(); iB++) {
+        EXPECT_EQ(parallelMesh.boundaryLoop(iB).halfedge().getIndex(),
+                  serialMesh.boundaryLoop(iB).halfedge().getIndex());
+      }
+    }
+  }
+
+  // Holes which touch at a corner put a vertex on the boundary twice. The parallel boundary pass cannot handle that, so
+  // it is rejected even if safety checks are disabled.
+  std::vector<std::vector<size_t>> pinched = holeyGridPolygons(200, [](size_t i, size_t j) {
+    return (i == 100 && j == 100) || (i == 101 && j == 101);
+  });
+  EXPECT_THROW(HalfedgeMesh(pinched, false, 8), std::runtime_error);
+}
+
+TEST_F(HalfedgeMeshSuite, ConstructionFlatFaceListTest) {
+  for (MeshAsset& a : allMeshes()) {
+    a.printThyName();
+    std::vector<std::vector<size_t>> polygons = a.mesh->getFaceVertexList();
+
+    std::vector<size_t> faceIndices, faceStart;
+    a.mesh->getFaceVertexListFlat(faceIndices, faceStart);
+    ASSERT_EQ(faceStart.size(), polygons.size() + 1);
+    ASSERT_EQ(faceIndices.size(), a.mesh->nCorners());
+
+    std::vector<uint32_t> faceIndices32;
+    std::vector<size_t> faceStart32;
+    a.mesh->getFaceVertexListFlat(faceIndices32, faceStart32);
+    EXPECT_EQ(std::vector<size_t>(faceIndices32.begin(), faceIndices32.end()), faceIndices);
+    EXPECT_EQ(faceStart32, faceStart);
+
+    HalfedgeMesh flatMesh(faceIndices32, faceStart);
+    EXPECT_EQ(flatMesh.getFaceVertexList(), polygons);
+    EXPECT_EQ(flatMesh.nHalfedges(), a.mesh->nHalfedges());
+    for (size_t iHe = 0; iHe < a.mesh->nHalfedges(); iHe++) {
+      EXPECT_EQ(flatMesh.halfedge(iHe).next().getIndex(), a.mesh->halfedge(iHe).next().getIndex());
+    }
+
+    if (a.mesh->isTriangular()) {
+      std::vector<std::array<size_t, 3>> triangles = a.mesh->getFaceVertexListTriangles();
+      HalfedgeMesh triMesh(triangles);
+      EXPECT_EQ(triMesh.getFaceVertexList(), polygons);
+      EXPECT_EQ(triMesh.nHalfedges(), a.mesh->nHalfedges());
+    }
+  }
+}
+
+TEST_F(HalfedgeMeshSuite, ConstructionInvalidInputTest) {
+  std::vector<std::vector<size_t>> selfEdge{{0, 1, 1}};
+  EXPECT_THROW(HalfedgeMesh mesh(selfEdge), std::runtime_error);
+
+  std::vector<std::vector<size_t>> duplicateEdge{{0, 1, 2}, {0, 1, 3}};
+  EXPECT_THROW(HalfedgeMesh mesh(duplicateEdge), std::runtime_error);
+
+  std::vector<std::vector<size_t>> lowDegree{{0, 1}};
+  EXPECT_THROW(HalfedgeMesh mesh(lowDegree), std::runtime_error);
+
+  // Errors from parallel construction are passed back to the calling thread
+  EXPECT_THROW(HalfedgeMesh mesh(duplicateEdge, false, 2), std::runtime_error);
+  std::vector<std::vector<size_t>> bowtie{{0, 1, 2}, {0, 3, 4}};
+  EXPECT_THROW(HalfedgeMesh mesh(bowtie), std::runtime_error);
+  EXPECT_THROW(HalfedgeMesh mesh(bowtie, false, 2), std::runtime_error);
+}
+
+// The compact triangle connectivity should describe the same mesh as the HalfedgeMesh it was built from
+TEST_F(HalfedgeMeshSuite, CompactTriangleMeshNavigationTest) {
+  for (MeshAsset& a : allMeshes()) {
+    if (!a.mesh->isTriangular()) continue;
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+
+    CompactTriangleMesh compact(mesh);
+    compact.validateConnectivity();
+    ASSERT_EQ(compact.nVertices(), mesh.nVertices());
+    ASSERT_EQ(compact.nFaces(), mesh.nFaces());
+    ASSERT_EQ(compact.nHalfedges(), mesh.nInteriorHalfedges());
+
+    // Building from the face list gives identical connectivity
+    CompactTriangleMesh fromList(mesh.getFaceVertexListTriangles());
+    fromList.validateConnectivity();
+    for (size_t iHe = 0; iHe < compact.nHalfedges(); iHe++) {
+      EXPECT_EQ(fromList.heVertex(iHe), compact.heVertex(iHe));
+      EXPECT_EQ(fromList.heTwin(iHe), compact.heTwin(iHe));
+    }
+
+    for (Face f : mesh.faces()) {
+      size_t iHe = CompactTriangleMesh::fHalfedge(f.getIndex());
+      for (Halfedge he : f.adjacentHalfedges()) {
+        EXPECT_EQ(compact.heVertex(iHe), he.vertex().getIndex());
+        EXPECT_EQ(compact.heTipVertex(iHe), he.twin().vertex().getIndex());
+        EXPECT_EQ(CompactTriangleMesh::heFace(iHe), f.getIndex());
+        if (he.edge().isBoundary()) {
+          EXPECT_TRUE(compact.heIsBoundary(iHe));
+        } else {
+          EXPECT_EQ(CompactTriangleMesh::heFace(compact.heTwin(iHe)), he.twin().face().getIndex());
+        }
+        iHe = CompactTriangleMesh::heNext(iHe);
+      }
+    }
+
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_EQ(compact.vertexIsBoundary(v.getIndex()), v.isBoundary());
+      size_t count = 0;
+      size_t iHe = compact.vHalfedge(v.getIndex());
+      do {
+        count++;
+        iHe = compact.vNextOutgoing(iHe);
+      } while (iHe != INVALID_IND && iHe != compact.vHalfedge(v.getIndex()));
+      EXPECT_EQ(count, v.faceDegree());
+    }
+
+    EXPECT_EQ(compact.toHalfedgeMesh()->getFaceVertexList(), mesh.getFaceVertexList());
+  }
+
+  std::vector<std::array<size_t, 3>> duplicateEdge{{0, 1, 2}, {0, 1, 3}};
+  EXPECT_THROW(CompactTriangleMesh mesh(duplicateEdge), std::runtime_error);
+  std::vector<std::array<size_t, 3>> bowtie{{0, 1, 2}, {0, 3, 4}};
+  EXPECT_THROW(CompactTriangleMesh mesh(bowtie), std::runtime_error);
+}
+
+// ============================================================
+// =============== Permutation tests
+// ============================================================
+
+TEST_F(HalfedgeMeshSuite, PermuteElementsTest) {
+  for (MeshAsset& a : allMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+
+    std::vector<std::vector<size_t>> polygons = mesh.getFaceVertexList();
+    size_t nBoundaryLoops = mesh.nBoundaryLoops();
+    VertexData<size_t> vOrig = mesh.getVertexIndices();
+    EdgeData<size_t> eOrig = mesh.getEdgeIndices();
+    FaceData<size_t> fOrig = mesh.getFaceIndices();
+    HalfedgeData<size_t> heOrig = mesh.getHalfedgeIndices();
+
+    // Some arbitrary permutations
+    auto makePerm = [](size_t n, size_t shift) {
+      std::vector<size_t> perm(n);
+      for (size_t i = 0; i < n; i++) perm[i] = (n - 1 - i + shift) % n;
+      return perm;
+    };
+    std::vector<size_t> vPerm = makePerm(mesh.nVertices(), 3);
+    std::vector<size_t> ePerm = makePerm(mesh.nEdges(), 5);
+    std::vector<size_t> fPerm = makePerm(mesh.nFaces(), 7);
+
+    mesh.permuteVertices(vPerm);
+    mesh.validateConnectivity();
+    mesh.permuteEdges(ePerm);
+    mesh.validateConnectivity();
+    mesh.permuteFaces(fPerm);
+    mesh.validateConnectivity();
+    EXPECT_FALSE(mesh.isCanonical());
+    EXPECT_EQ(mesh.nBoundaryLoops(), nBoundaryLoops);
+
+    // Containers followed their elements
+    for (size_t i = 0; i < mesh.nVertices(); i++) EXPECT_EQ(vOrig[mesh.vertex(i)], vPerm[i]);
+    for (size_t i = 0; i < mesh.nEdges(); i++) EXPECT_EQ(eOrig[mesh.edge(i)], ePerm[i]);
+    for (size_t i = 0; i < mesh.nFaces(); i++) EXPECT_EQ(fOrig[mesh.face(i)], fPerm[i]);
+    for (Halfedge he : mesh.halfedges()) {
+      EXPECT_EQ(heOrig[he] / 2, eOrig[he.edge()]);
+    }
+
+    // The faces are the same, relabeled
+    for (Face f : mesh.faces()) {
+      std::vector<size_t> faceVerts;
+      for (Vertex v : f.adjacentVertices()) faceVerts.push_back(vOrig[v]);
+      std::vector<size_t> expected = polygons[fOrig[f]];
+      std::rotate(expected.begin(), std::find(expected.begin(), expected.end(), faceVerts[0]), expected.end());
+      EXPECT_EQ(faceVerts, expected);
+    }
+  }
+}
+
+TEST_F(HalfedgeMeshSuite, DynamicElementPermuteTest) {
+  for (MeshAsset& a : allMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+
+    VertexData<size_t> vOrig = mesh.getVertexIndices();
+    EdgeData<size_t> eOrig = mesh.getEdgeIndices();
+    FaceData<size_t> fOrig = mesh.getFaceIndices();
+    HalfedgeData<size_t> heOrig = mesh.getHalfedgeIndices();
+    BoundaryLoopData<size_t> blOrig = mesh.getBoundaryLoopIndices();
+
+    // Hold dynamic references to every element, including some which are copied, moved, and destroyed
+    std::vector<DynamicVertex> dynVerts;
+    for (Vertex v : mesh.vertices()) dynVerts.emplace_back(v);
+    std::vector<DynamicEdge> dynEdges;
+    for (Edge e : mesh.edges()) dynEdges.emplace_back(e);
+    std::vector<DynamicFace> dynFaces;
+    for (Face f : mesh.faces()) dynFaces.emplace_back(f);
+    std::vector<DynamicHalfedge> dynHalfedges;
+    for (Halfedge he : mesh.halfedges()) dynHalfedges.emplace_back(he);
+    std::vector<DynamicBoundaryLoop> dynLoops;
+    for (BoundaryLoop bl : mesh.boundaryLoops()) dynLoops.emplace_back(bl);
+    {
+      std::vector<DynamicVertex> temp(dynVerts.begin(), dynVerts.begin() + dynVerts.size() / 2);
+    }
+    DynamicVertex nullVertex;
+    DynamicVertex nullCopy(nullVertex);
+
+    auto reverse = [](size_t n) {
+      std::vector<size_t> perm(n);
+      for (size_t i = 0; i < n; i++) perm[i] = n - 1 - i;
+      return perm;
+    };
+    mesh.permuteVertices(reverse(mesh.nVertices()));
+    mesh.permuteEdges(reverse(mesh.nEdges()));
+    mesh.permuteFaces(reverse(mesh.nFaces()));
+
+    // Dynamic elements still refer to the same element
+    for (size_t i = 0; i < dynVerts.size(); i++) EXPECT_EQ(vOrig[dynVerts[i]], i);
+    for (size_t i = 0; i < dynEdges.size(); i++) EXPECT_EQ(eOrig[dynEdges[i]], i);
+    for (size_t i = 0; i < dynFaces.size(); i++) EXPECT_EQ(fOrig[dynFaces[i]], i);
+    for (size_t i = 0; i < dynHalfedges.size(); i++) EXPECT_EQ(heOrig[dynHalfedges[i]], i);
+    for (size_t i = 0; i < dynLoops.size(); i++) {
+      EXPECT_EQ(blOrig[dynLoops[i]], i);
+      EXPECT_EQ(dynLoops[i].halfedge().face().asBoundaryLoop(), dynLoops[i].decay());
+    }
+    EXPECT_EQ(nullCopy.getIndex(), INVALID_IND);
+  }
+}
+
+TEST_F(HalfedgeMeshSuite, DynamicElementOutlivesMeshTest) {
+  std::unique_ptr<HalfedgeMesh> mesh = getAsset("lego.ply").mesh;
+  DynamicVertex v(mesh->vertex(0));
+  mesh.reset();
+  EXPECT_EQ(v.getMesh(), nullptr);
+}
+
 // ============================================================
 // =============== Range iterator tests
 // ============================================================
@@ -216,6 +527,191 @@ TEST_F(HalfedgeMeshSuite, ContainerMeshDestructTest) {
   ASSERT_EQ(2 + 2, 4); // debugging is easier if failure isn't last
 }
 
+// Short-lived containers reuse buffers from an arena, and list nodes from the mesh
+TEST_F(HalfedgeMeshSuite, ContainerRecyclingTest) {
+  std::unique_ptr<HalfedgeMesh> mesh = getAsset("spot.ply").mesh;
+
+  BufferArena arena;
+  const double* firstBuffer;
+  size_t nSpares = mesh->spareExpandCallbacks.size();
+  {
+    VertexData<double> scratch(*mesh, 1.);
+    firstBuffer = scratch.asVector().data();
+  }
+  EXPECT_EQ(arena.cachedBytes(), mesh->nVerticesCapacity() * sizeof(double));
+  EXPECT_EQ(mesh->spareExpandCallbacks.size(), std::max(nSpares, (size_t)1));
+
+  size_t nCallbacks = mesh->vertexExpandCallbackList.size();
+  nSpares = mesh->spareExpandCallbacks.size();
+  {
+    VertexData<double> scratch(*mesh, 2.);
+    EXPECT_EQ(scratch.asVector().data(), firstBuffer);
+    EXPECT_EQ(scratch[mesh->vertex(0)], 2.);
+    EXPECT_EQ(mesh->vertexExpandCallbackList.size(), nCallbacks + 1);
+    EXPECT_EQ(mesh->spareExpandCallbacks.size(), nSpares - 1);
+    EXPECT_EQ(arena.cachedBytes(), 0u);
+
+    // The container still follows the mesh
+    mesh->insertVertexAlongEdge(mesh->edge(0));
+    EXPECT_EQ(scratch[mesh->vertex(mesh->nVertices() - 1)], 2.);
+  }
+  EXPECT_EQ(mesh->vertexExpandCallbackList.size(), nCallbacks);
+
+  // The cache never grows past its cap
+  size_t bufferBytes = mesh->nVerticesCapacity() * sizeof(double);
+  arena.clear();
+  arena.setMaxCachedBytes(bufferBytes);
+  {
+    VertexData<double> scratchA(*mesh, 1.);
+    VertexData<double> scratchB(*mesh, 1.);
+  }
+  EXPECT_EQ(arena.cachedBytes(), bufferBytes);
+  arena.setMaxCachedBytes(0);
+  EXPECT_EQ(arena.cachedBytes(), 0u);
+}
+
+// Containers on a frozen mesh don't touch it, so they can be created from many threads at once
+TEST_F(HalfedgeMeshSuite, FrozenMeshTest) {
+  std::unique_ptr<HalfedgeMesh> mesh = getAsset("spot.ply").mesh;
+  size_t nCallbacks = mesh->vertexExpandCallbackList.size();
+
+  mesh->freeze();
+  EXPECT_TRUE(mesh->isFrozen());
+  std::vector<double> sums(4, 0.);
+  std::vector<std::thread> threads;
+  for (size_t iThread = 0; iThread < sums.size(); iThread++) {
+    threads.emplace_back([&, iThread]() {
+      for (int iRep = 0; iRep < 50; iRep++) {
+        VertexData<double> scratch(*mesh, 1.);
+        FaceData<Vector3> faceScratch(*mesh);
+        DynamicVertex v(mesh->vertex(iRep));
+        sums[iThread] += scratch[v] + scratch.toVector().sum();
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (double sum : sums) {
+    EXPECT_EQ(sum, 50. * (1. + mesh->nVertices()));
+  }
+  EXPECT_EQ(mesh->vertexExpandCallbackList.size(), nCallbacks);
+
+  // No mutation while frozen, and no unfreezing while containers from the frozen mesh are alive
+  {
+    VertexData<double> data(*mesh, 0.);
+    EXPECT_THROW(mesh->insertVertexAlongEdge(mesh->edge(0)), std::runtime_error);
+    EXPECT_THROW(mesh->unfreeze(), std::runtime_error);
+  }
+  { // Nor while dynamic elements from the frozen mesh are alive, since they would not follow a permutation
+    DynamicVertex v(mesh->vertex(0));
+    DynamicVertex vCopy(v);
+    EXPECT_THROW(mesh->unfreeze(), std::runtime_error);
+  }
+
+  // Thawed dynamic elements are registered, and follow permutations after unfreezing
+  DynamicVertex thawed(mesh->vertex(0));
+  thawed.thaw();
+  mesh->unfreeze();
+  EXPECT_FALSE(mesh->isFrozen());
+  std::vector<size_t> newToOld(mesh->nVertices());
+  for (size_t i = 0; i < newToOld.size(); i++) newToOld[i] = newToOld.size() - 1 - i;
+  mesh->permuteVertices(newToOld);
+  EXPECT_EQ(thawed.getIndex(), mesh->nVertices() - 1);
+
+  VertexData<double> data(*mesh, 0.);
+  mesh->insertVertexAlongEdge(mesh->edge(0));
+  EXPECT_EQ(data.size(), mesh->nVertices());
+}
+
+TEST_F(HalfedgeMeshSuite, ContainerEigenViewTest) {
+  for (MeshAsset& a : allMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexData<Vector3>& positions = a.geometry->inputVertexPositions;
+
+    // Positions as an N x 3 matrix, sharing storage with the container
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> posMat = positions.asMatrix();
+    ASSERT_EQ((size_t)posMat.rows(), mesh.nVertices());
+    ASSERT_EQ(posMat.cols(), 3);
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_EQ(posMat(v.getIndex(), 2), positions[v].z);
+    }
+    posMat.col(0).setConstant(7.);
+    EXPECT_EQ(positions[mesh.vertex(0)].x, 7.);
+
+    // Scalars as a vector, and the conversions which use it
+    EdgeData<double> edgeVals(mesh);
+    Eigen::Map<Eigen::VectorXd> edgeVec = edgeVals.asVector();
+    for (size_t i = 0; i < mesh.nEdges(); i++) edgeVec[i] = i;
+    for (Edge e : mesh.edges()) {
+      EXPECT_EQ(edgeVals[e], e.getIndex());
+    }
+    EXPECT_EQ(edgeVals.toVector(), edgeVec);
+    EdgeData<double> fromVec(mesh, Eigen::VectorXd(2. * edgeVec));
+    EXPECT_EQ(fromVec[mesh.edge(1)], 2.);
+
+    // Other types made of doubles are viewed with one column per component
+    FaceData<Vector2> faceVals(mesh, Vector2{1., 2.});
+    EXPECT_EQ(faceVals.asMatrix().cols(), 2);
+    EXPECT_EQ(faceVals.asMatrix().sum(), 3. * mesh.nFaces());
+    EXPECT_EQ(edgeVals.asMatrix().cols(), 1);
+
+    // Corners on a mesh with boundary are not dense, so the conversions fall back on iterating
+    CornerData<double> cornerVals(mesh, 1.);
+    EXPECT_EQ((size_t)cornerVals.toVector().size(), mesh.nCorners());
+  }
+}
+
+TEST_F(HalfedgeMeshSuite, ColumnContainerTest) {
+  for (MeshAsset& a : allMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexData<Vector3>& positions = a.geometry->inputVertexPositions;
+
+    // Round trip through the column layout
+    VertexColumnData<Vector3> columnPositions(positions);
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_EQ(Vector3(columnPositions[v]), positions[v]);
+    }
+    VertexData<Vector3> roundTrip = columnPositions.toMeshData();
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_EQ(roundTrip[v], positions[v]);
+    }
+
+    // Writes through the proxy land in the columns
+    for (Vertex v : mesh.vertices()) {
+      columnPositions[v] += Vector3{1., 2., 3.};
+    }
+    Eigen::Map<Eigen::VectorXd, Eigen::Aligned16> yColumn = columnPositions.column(1);
+    ASSERT_EQ((size_t)yColumn.size(), mesh.nVertices());
+    for (size_t i = 0; i < mesh.nVertices(); i++) {
+      EXPECT_EQ(yColumn[i], positions[i].y + 2.);
+    }
+    yColumn.setZero();
+    EXPECT_EQ(Vector3(columnPositions[0]).y, 0.);
+
+    // Columns follow the mesh through permutations and growth
+    HalfedgeColumnData<std::array<Vector3, 2>> pairs(mesh);
+    for (Halfedge he : mesh.halfedges()) {
+      pairs[he] = std::array<Vector3, 2>{{positions[he.vertex()], positions[he.twin().vertex()]}};
+    }
+    std::vector<size_t> reverse(mesh.nEdges());
+    for (size_t i = 0; i < reverse.size(); i++) reverse[i] = reverse.size() - 1 - i;
+    mesh.permuteEdges(reverse);
+    size_t nVerticesOrig = mesh.nVertices();
+    for (size_t i = 0; i < 10; i++) {
+      mesh.insertVertexAlongEdge(mesh.edge(i % mesh.nEdges()));
+    }
+    for (Halfedge he : mesh.halfedges()) {
+      if (he.vertex().getIndex() >= nVerticesOrig || he.twin().vertex().getIndex() >= nVerticesOrig) continue;
+      std::array<Vector3, 2> val = pairs[he];
+      EXPECT_EQ(val[0], positions[he.vertex()]);
+      EXPECT_EQ(val[1], positions[he.twin().vertex()]);
+    }
+  }
+}
+
 // ============================================================
 // =============== Navigators
 // ============================================================
@@ -1,4 +1,5 @@
 
+#include "geometrycentral/surface/compact_triangle_mesh.h"
 #include "geometrycentral/surface/halfedge_mesh.h"
 #include "geometrycentral/surface/meshio.h"
 
@@ -13,6 +14,7 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <unordered_set>
@@ -47,6 +49,94 @@ TEST_F(HalfedgeMutationSuite, EdgeFlipTest) {
   }
 }
 
+// Flip, split and insert on the compact triangle connectivity, and compare against HalfedgeMesh
+TEST_F(HalfedgeMutationSuite, CompactTriangleMeshMutationTest) {
+
+  for (MeshAsset& a : allMeshes()) {
+    if (!a.mesh->isTriangular()) continue;
+    a.printThyName();
+
+    CompactTriangleMesh compact(*a.mesh);
+
+    int count = 10;
+    size_t indInc = static_cast<size_t>(std::ceil(compact.nHalfedges() / static_cast<double>(count)));
+    size_t ind = 0;
+    for (int i = 0; i < count; i++) {
+
+      compact.flip(ind);
+      compact.validateConnectivity();
+
+      size_t iV = compact.splitEdge((ind + 1) % compact.nHalfedges());
+      compact.validateConnectivity();
+      EXPECT_EQ(iV, compact.nVertices() - 1);
+
+      compact.insertVertex(CompactTriangleMesh::heFace(ind));
+      compact.validateConnectivity();
+
+      ind = (ind + indInc) % compact.nHalfedges();
+    }
+
+    // The topology is unchanged
+    size_t nBoundaryHalfedges = 0;
+    for (size_t iHe = 0; iHe < compact.nHalfedges(); iHe++) {
+      if (compact.heIsBoundary(iHe)) nBoundaryHalfedges++;
+    }
+    size_t nEdges = (compact.nHalfedges() + nBoundaryHalfedges) / 2;
+    int chi = static_cast<int>(compact.nVertices() + compact.nFaces()) - static_cast<int>(nEdges);
+    EXPECT_EQ(chi, a.mesh->eulerCharacteristic() - static_cast<int>(a.mesh->nBoundaryLoops()));
+  }
+
+  // Operations along the boundary
+  CompactTriangleMesh tri(std::vector<std::array<size_t, 3>>{{0, 1, 2}});
+  EXPECT_FALSE(tri.flip(0));
+  size_t iV = tri.splitEdge(0);
+  tri.validateConnectivity();
+  EXPECT_EQ(tri.nFaces(), 2);
+  EXPECT_TRUE(tri.vertexIsBoundary(iV));
+  EXPECT_EQ(tri.heTwin(1), 5); // the new interior edge (m -> 2)
+  EXPECT_TRUE(tri.flip(1));
+  tri.validateConnectivity();
+  tri.insertVertex(1);
+  tri.validateConnectivity();
+  EXPECT_EQ(tri.toHalfedgeMesh()->nBoundaryLoops(), 1);
+}
+
+// Flipping an edge should give the same triangles as HalfedgeMesh::flip()
+TEST_F(HalfedgeMutationSuite, CompactTriangleMeshFlipMatchTest) {
+
+  auto asset = getAsset("sphere_small.ply");
+  HalfedgeMesh& mesh = *asset.mesh;
+  CompactTriangleMesh compact(mesh);
+
+  // Only flip edges whose neighborhoods have not been touched yet, so neither mesh ever sees a degenerate flip
+  VertexData<char> touched(mesh, false);
+  for (size_t iF = 0; iF < mesh.nFaces(); iF++) {
+    Halfedge he = mesh.face(iF).halfedge();
+    std::vector<Vertex> diamond{he.vertex(), he.next().vertex(), he.next().next().vertex(),
+                                he.twin().next().next().vertex()};
+    bool skip = false;
+    for (Vertex v : diamond) skip = skip || touched[v];
+    if (skip) continue;
+    for (Vertex v : diamond) touched[v] = true;
+
+    size_t iHe = CompactTriangleMesh::fHalfedge(iF);
+    while (compact.heVertex(iHe) != he.vertex().getIndex()) iHe = CompactTriangleMesh::heNext(iHe);
+
+    ASSERT_TRUE(mesh.flip(he.edge()));
+    ASSERT_TRUE(compact.flip(iHe));
+    compact.validateConnectivity();
+
+    // Compare triangles up to rotation
+    for (size_t iCheck : {iF, he.twin().face().getIndex()}) {
+      std::vector<size_t> expected;
+      for (Vertex v : mesh.face(iCheck).adjacentVertices()) expected.push_back(v.getIndex());
+      std::array<size_t, 3> actual = compact.getFaceVertexList()[iCheck];
+      std::rotate(expected.begin(), std::find(expected.begin(), expected.end(), actual[0]), expected.end());
+      EXPECT_EQ(expected, std::vector<size_t>(actual.begin(), actual.end()));
+    }
+  }
+}
+
 // Flip a lot of edges on one mesh without boundary
 TEST_F(HalfedgeMutationSuite, EdgeFlipClosedManyTest) {
 
@@ -176,6 +266,128 @@ TEST_F(HalfedgeMutationSuite, EdgeSplitTest) {
   }
 }
 
+// Collapse some edges, then clean up the tombstones
+TEST_F(HalfedgeMutationSuite, EdgeCollapseTest) {
+
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+    VertexData<size_t> origInd = mesh.getVertexIndices();
+    int eulerChar = mesh.eulerCharacteristic();
+
+    size_t nCollapsed = 0;
+    for (size_t i = 0; i < 20; i++) {
+
+      // Pick some edge
+      size_t target = (37 * i) % mesh.nEdges();
+      size_t count = 0;
+      Edge eCollapse;
+      for (Edge e : mesh.edges()) {
+        if (count++ == target) eCollapse = e;
+      }
+
+      size_t nVertices = mesh.nVertices();
+      Vertex vKeep = mesh.collapseEdge(eCollapse);
+      if (vKeep == Vertex()) continue;
+      nCollapsed++;
+      mesh.validateConnectivity();
+      EXPECT_EQ(mesh.nVertices(), nVertices - 1);
+      EXPECT_EQ(mesh.eulerCharacteristic(), eulerChar);
+    }
+    EXPECT_GT(nCollapsed, 0);
+    EXPECT_FALSE(mesh.isCompressed());
+
+    // Iteration skips the dead elements
+    size_t nIterated = 0;
+    for (Face f : mesh.faces()) {
+      EXPECT_TRUE(f.isTriangle());
+      nIterated++;
+    }
+    EXPECT_EQ(nIterated, mesh.nFaces());
+
+    // Compressing preserves the order of the remaining elements
+    mesh.compress();
+    EXPECT_TRUE(mesh.isCompressed());
+    mesh.validateConnectivity();
+    for (size_t iV = 0; iV + 1 < mesh.nVertices(); iV++) {
+      EXPECT_LT(origInd[mesh.vertex(iV)], origInd[mesh.vertex(iV + 1)]);
+    }
+  }
+}
+
+// Collapse edges with and without incremental compaction, and check that the results agree
+TEST_F(HalfedgeMutationSuite, IncrementalCompactionTest) {
+
+  auto faceLabels = [](HalfedgeMesh& mesh, VertexData<size_t>& label) {
+    std::vector<std::vector<size_t>> faces;
+    for (Face f : mesh.faces()) {
+      std::vector<size_t> face;
+      for (Vertex v : f.adjacentVertices()) face.push_back(label[v]);
+      std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+      faces.push_back(face);
+    }
+    std::sort(faces.begin(), faces.end());
+    return faces;
+  };
+
+  for (MeshAsset& a : closedMeshes()) {
+    if (!a.mesh->isTriangular()) continue;
+    a.printThyName();
+    HalfedgeMesh& refMesh = *a.mesh;
+    std::unique_ptr<HalfedgeMesh> meshPtr = refMesh.copy();
+    HalfedgeMesh& mesh = *meshPtr;
+    VertexData<size_t> refLabel = refMesh.getVertexIndices();
+    VertexData<size_t> label = mesh.getVertexIndices();
+    DynamicVertex vLast(mesh.vertex(mesh.nVertices() - 1));
+    size_t vLastLabel = label[vLast];
+    size_t nVerticesOrig = mesh.nVertices();
+
+    // Enough moves to fill every hole left by a collapse
+    mesh.setAutoCompaction(8);
+
+    for (size_t i = 0; i < 30; i++) {
+
+      // Pick an edge in the reference mesh, and find the same one in the other mesh
+      size_t target = (101 * i) % refMesh.nEdges();
+      size_t count = 0;
+      Edge eRef;
+      for (Edge e : refMesh.edges()) {
+        if (count++ == target) eRef = e;
+      }
+      size_t tail = refLabel[eRef.halfedge().vertex()];
+      size_t tip = refLabel[eRef.halfedge().twin().vertex()];
+      Edge eMatch;
+      for (Edge e : mesh.edges()) {
+        if (label[e.halfedge().vertex()] == tail && label[e.halfedge().twin().vertex()] == tip) eMatch = e;
+      }
+      ASSERT_NE(eMatch, Edge());
+
+      Vertex vRef = refMesh.collapseEdge(eRef);
+      Vertex v = mesh.collapseEdge(eMatch);
+      ASSERT_EQ(vRef == Vertex(), v == Vertex());
+      if (v == Vertex()) continue;
+      EXPECT_EQ(label[v], refLabel[vRef]);
+
+      // The holes were filled as we went
+      EXPECT_TRUE(mesh.isCompressed());
+    }
+
+    mesh.validateConnectivity();
+    EXPECT_LT(mesh.nVertices(), nVerticesOrig);
+    EXPECT_EQ(mesh.nVertices(), refMesh.nVertices());
+    EXPECT_EQ(faceLabels(mesh, label), faceLabels(refMesh, refLabel));
+
+    // Dynamic elements followed the moved elements (unless they were collapsed away)
+    bool vLastAlive = false;
+    for (Vertex v : refMesh.vertices()) {
+      if (refLabel[v] == vLastLabel) vLastAlive = true;
+    }
+    if (vLastAlive) {
+      EXPECT_EQ(label[vLast], vLastLabel);
+    }
+  }
+}
+
 // =====================================================
 // ========= Container tests
 // =====================================================
@@ -330,6 +542,103 @@ TEST_F(HalfedgeMutationSuite, ContainerExpandTest) {
   }
 }
 
+// Expansion callbacks are deferred while batching, and invoked once per element type at the end
+TEST_F(HalfedgeMutationSuite, BatchedMutationTest) {
+
+  auto asset = getAsset("sphere_small.ply");
+  HalfedgeMesh& mesh = *asset.mesh;
+
+  size_t nVertexOrig = mesh.nVertices();
+  size_t nEdgeOrig = mesh.nEdges();
+  VertexData<int> vData(mesh, 42);
+  EdgeData<int> eData(mesh, 42);
+  FaceData<int> fData(mesh, 42);
+  for (Vertex v : mesh.vertices()) vData[v] = 17;
+
+  size_t nVertexExpand = 0;
+  size_t nEdgeExpand = 0;
+  size_t lastEdgeCapacity = 0;
+  auto vIt = mesh.vertexExpandCallbackList.insert(mesh.vertexExpandCallbackList.end(),
+                                                  [&](size_t) { nVertexExpand++; });
+  auto eIt = mesh.edgeExpandCallbackList.insert(mesh.edgeExpandCallbackList.end(), [&](size_t newCapacity) {
+    nEdgeExpand++;
+    lastEdgeCapacity = newCapacity;
+  });
+
+  // Enough splits to double the capacity a few times
+  mesh.beginBatch();
+  mesh.beginBatch();
+  for (size_t i = 0; i < 4 * nEdgeOrig; i++) {
+    mesh.splitEdgeTriangular(mesh.edge(i % mesh.nEdges()));
+  }
+  mesh.endBatch();
+  EXPECT_TRUE(mesh.isInBatch());
+  for (size_t i = 0; i < nVertexOrig; i++) {
+    mesh.insertVertex(mesh.face(i));
+  }
+  EXPECT_EQ(nVertexExpand, 0);
+  EXPECT_EQ(nEdgeExpand, 0);
+  mesh.endBatch();
+  EXPECT_FALSE(mesh.isInBatch());
+
+  mesh.validateConnectivity();
+  EXPECT_EQ(nVertexExpand, 1);
+  EXPECT_EQ(nEdgeExpand, 1);
+  EXPECT_EQ(lastEdgeCapacity, mesh.nEdgesCapacity());
+
+  // All containers now cover the new elements
+  size_t origValCount = 0;
+  for (Vertex v : mesh.vertices()) {
+    EXPECT_TRUE(vData[v] == 17 || vData[v] == 42);
+    if (vData[v] == 17) origValCount++;
+  }
+  EXPECT_EQ(origValCount, nVertexOrig);
+  for (Edge e : mesh.edges()) EXPECT_EQ(eData[e], 42);
+  for (Face f : mesh.faces()) EXPECT_EQ(fData[f], 42);
+
+  mesh.vertexExpandCallbackList.erase(vIt);
+  mesh.edgeExpandCallbackList.erase(eIt);
+}
+
+// After reserving, growing the mesh up to that size does not expand again
+TEST_F(HalfedgeMutationSuite, ReserveTest) {
+
+  for (MeshAsset& a : triangularMeshes()) {
+    a.printThyName();
+    HalfedgeMesh& mesh = *a.mesh;
+
+    VertexData<int> vData(mesh, 42);
+    FaceData<int> fData(mesh, 42);
+    size_t nExpand = 0;
+    auto vIt = mesh.vertexExpandCallbackList.insert(mesh.vertexExpandCallbackList.end(), [&](size_t) { nExpand++; });
+    auto eIt = mesh.edgeExpandCallbackList.insert(mesh.edgeExpandCallbackList.end(), [&](size_t) { nExpand++; });
+    auto fIt = mesh.faceExpandCallbackList.insert(mesh.faceExpandCallbackList.end(), [&](size_t) { nExpand++; });
+
+    // Each insertVertex() adds 1 vertex, 3 edges and 2 faces
+    size_t count = 20;
+    mesh.reserve(mesh.nVertices() + count, mesh.nEdges() + 3 * count, mesh.nFaces() + 2 * count);
+    mesh.validateConnectivity();
+    EXPECT_EQ(nExpand, 3);
+    EXPECT_GE(mesh.nVerticesCapacity(), mesh.nVertices() + count);
+
+    // Reserving less than the current capacity does nothing
+    mesh.reserve(0, 0, 0);
+    EXPECT_EQ(nExpand, 3);
+
+    for (size_t i = 0; i < count; i++) {
+      mesh.insertVertex(mesh.face(i));
+    }
+    mesh.validateConnectivity();
+    EXPECT_EQ(nExpand, 3);
+    for (Vertex v : mesh.vertices()) EXPECT_EQ(vData[v], 42);
+    for (Face f : mesh.faces()) EXPECT_EQ(fData[f], 42);
+
+    mesh.vertexExpandCallbackList.erase(vIt);
+    mesh.edgeExpandCallbackList.erase(eIt);
+    mesh.faceExpandCallbackList.erase(fIt);
+  }
+}
+
 
 // =====================================================
 // ========= Mutation helper tests
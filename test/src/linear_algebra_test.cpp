@@ -760,4 +760,396 @@ TEST_F(LinearAlgebraTestSuite, TestQRSolvers_wide) {
   }
 }
 
+TEST_F(LinearAlgebraTestSuite, TestCholeskyModes) {
+
+  SparseMatrix<double> mat = buildSPDTestMatrix<double>();
+  Vector<double> rhs = randomVector<double>(mat.rows());
+
+  for (CholeskyMode mode : {CholeskyMode::Auto, CholeskyMode::SimplicialLDLT, CholeskyMode::SupernodalLLT}) {
+    for (CholeskyOrdering ordering : {CholeskyOrdering::Default, CholeskyOrdering::AMD}) {
+      PositiveDefiniteSolver<double> solver(mat, mode, ordering);
+      Vector<double> x = solver.solve(rhs);
+      EXPECT_LT(residual(mat, x, rhs), 1e-4);
+    }
+  }
+
+  { // complex, supernodal
+    SparseMatrix<std::complex<double>> matC = buildSPDTestMatrix<std::complex<double>>();
+    Vector<std::complex<double>> rhsC = randomVector<std::complex<double>>(matC.rows());
+    PositiveDefiniteSolver<std::complex<double>> solver(matC, CholeskyMode::SupernodalLLT);
+    Vector<std::complex<double>> x = solver.solve(rhsC);
+    EXPECT_LT(residual(matC, x, rhsC), 1e-4);
+  }
+
+#ifdef GC_HAVE_SUITESPARSE
+  { // large enough that cholmod picks a supernodal factorization in auto mode
+
+    // Graph Laplacian of a 3D grid (which has lots of fill), plus the identity so it is safely definite. Whether a
+    // factorization of an exactly semi-definite matrix succeeds depends on the rounding of the last pivot, so only
+    // matrices well away from singular are used here.
+    const int n = 20;
+    auto gridIndex = [&](int i, int j, int k) { return (i * n + j) * n + k; };
+    std::vector<Eigen::Triplet<double>> tripletList;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        for (int k = 0; k < n; k++) {
+          int vA = gridIndex(i, j, k);
+          tripletList.emplace_back(vA, vA, 1.);
+          for (int vB : {i + 1 < n ? gridIndex(i + 1, j, k) : -1, j + 1 < n ? gridIndex(i, j + 1, k) : -1,
+                         k + 1 < n ? gridIndex(i, j, k + 1) : -1}) {
+            if (vB == -1) continue;
+            tripletList.emplace_back(vA, vA, 1.);
+            tripletList.emplace_back(vB, vB, 1.);
+            tripletList.emplace_back(vA, vB, -1.);
+            tripletList.emplace_back(vB, vA, -1.);
+          }
+        }
+      }
+    }
+    SparseMatrix<double> definite(n * n * n, n * n * n);
+    definite.setFromTriplets(tripletList.begin(), tripletList.end());
+    Vector<double> rhsL = randomVector<double>(definite.rows());
+
+    for (CholeskyMode mode : {CholeskyMode::Auto, CholeskyMode::SimplicialLDLT, CholeskyMode::SupernodalLLT}) {
+      PositiveDefiniteSolver<double> solver(definite, mode);
+      Vector<double> x = solver.solve(rhsL);
+      EXPECT_LT(residual(definite, x, rhsL), 1e-4);
+    }
+
+    // Make one diagonal entry very negative. Every pivot involving it is then bounded away from zero (its Schur
+    // complement is at most -1000), so the LLt is sure to fail and the LDLt is sure to succeed, on any platform.
+    SparseMatrix<double> indefinite = definite;
+    indefinite.coeffRef(n * n * n / 2, n * n * n / 2) = -1000.;
+    EXPECT_THROW(PositiveDefiniteSolver<double>(indefinite, CholeskyMode::SupernodalLLT), std::runtime_error);
+    for (CholeskyMode mode : {CholeskyMode::Auto, CholeskyMode::SimplicialLDLT}) {
+      PositiveDefiniteSolver<double> solver(indefinite, mode);
+      Vector<double> x = solver.solve(rhsL);
+      EXPECT_LT(residual(indefinite, x, rhsL), 1e-4);
+    }
+  }
+#endif
+}
+
+TEST_F(LinearAlgebraTestSuite, TestMultipleRHSSolvers) {
+
+  const size_t nRHS = 8;
+
+  { // double
+    SparseMatrix<double> mat = buildSPDTestMatrix<double>();
+    mat = mat.topLeftCorner(100, 100);
+    DenseMatrix<double> rhs(mat.rows(), nRHS);
+    for (size_t j = 0; j < nRHS; j++) {
+      rhs.col(j) = randomVector<double>(mat.rows());
+    }
+
+    // Each column of the blocked solve should match the single-vector solve
+    PositiveDefiniteSolver<double> pdSolver(mat);
+    DenseMatrix<double> x1;
+    pdSolver.solve(x1, rhs);
+    ASSERT_EQ(x1.rows(), mat.rows());
+    ASSERT_EQ(x1.cols(), (long int)nRHS);
+    for (size_t j = 0; j < nRHS; j++) {
+      Vector<double> rhsCol = rhs.col(j);
+      Vector<double> xCol = x1.col(j);
+      EXPECT_LT(residual(mat, xCol, rhsCol), 1e-4);
+      EXPECT_LT((xCol - pdSolver.solve(rhsCol)).norm(), 1e-8);
+    }
+
+    SquareSolver<double> squareSolver(mat);
+    DenseMatrix<double> x2;
+    squareSolver.solve(x2, rhs);
+    EXPECT_LT((x2 - x1).norm(), 1e-8);
+
+#ifndef GC_HAVE_SUITESPARSE
+    // Eigen is really slow, so use a tiny matrix
+    mat = mat.topLeftCorner(10, 10);
+    rhs = rhs.topRows(10).eval();
+#endif
+    Solver<double> qrSolver(mat);
+    DenseMatrix<double> x3;
+    qrSolver.solve(x3, rhs);
+    for (size_t j = 0; j < nRHS; j++) {
+      Vector<double> rhsCol = rhs.col(j);
+      Vector<double> xCol = x3.col(j);
+      EXPECT_LT(residual(mat, xCol, rhsCol), 1e-4);
+    }
+  }
+
+  { // std::complex<double>
+    SparseMatrix<std::complex<double>> mat = buildSPDTestMatrix<std::complex<double>>();
+    mat = mat.topLeftCorner(100, 100);
+    DenseMatrix<std::complex<double>> rhs(mat.rows(), nRHS);
+    for (size_t j = 0; j < nRHS; j++) {
+      rhs.col(j) = randomVector<std::complex<double>>(mat.rows());
+    }
+
+    PositiveDefiniteSolver<std::complex<double>> solver(mat);
+    DenseMatrix<std::complex<double>> x;
+    solver.solve(x, rhs);
+    for (size_t j = 0; j < nRHS; j++) {
+      Vector<std::complex<double>> rhsCol = rhs.col(j);
+      Vector<std::complex<double>> xCol = x.col(j);
+      EXPECT_LT(residual(mat, xCol, rhsCol), 1e-4);
+    }
+  }
+}
+
+TEST_F(LinearAlgebraTestSuite, TestRepeatedSolves) {
+
+  // The solver keeps its solution and workspace buffers between solves, so solve many times with a changing number of
+  // right hand sides and make sure each result matches a fresh solver
+  const std::vector<size_t> nRHSs{1, 8, 3, 8, 1, 5};
+
+  { // double
+    SparseMatrix<double> mat = buildSPDTestMatrix<double>();
+    mat = mat.topLeftCorner(100, 100);
+
+    PositiveDefiniteSolver<double> solver(mat);
+    for (size_t nRHS : nRHSs) {
+      DenseMatrix<double> rhs(mat.rows(), nRHS);
+      for (size_t j = 0; j < nRHS; j++) {
+        rhs.col(j) = randomVector<double>(mat.rows());
+      }
+
+      DenseMatrix<double> x;
+      solver.solve(x, rhs);
+      PositiveDefiniteSolver<double> freshSolver(mat);
+      DenseMatrix<double> xRef;
+      freshSolver.solve(xRef, rhs);
+      ASSERT_EQ(x.cols(), (long int)nRHS);
+      EXPECT_LT((x - xRef).norm(), 1e-8);
+
+      Vector<double> rhsCol = rhs.col(0);
+      EXPECT_LT((solver.solve(rhsCol) - xRef.col(0)).norm(), 1e-8);
+    }
+  }
+
+  { // float, which goes through double precision buffers
+    SparseMatrix<double> matD = buildSPDTestMatrix<double>();
+    matD = matD.topLeftCorner(100, 100);
+    SparseMatrix<float> mat = matD.cast<float>();
+
+    PositiveDefiniteSolver<float> solver(mat);
+    PositiveDefiniteSolver<double> solverD(matD);
+    for (size_t nRHS : nRHSs) {
+      DenseMatrix<float> rhs(mat.rows(), nRHS);
+      for (size_t j = 0; j < nRHS; j++) {
+        rhs.col(j) = randomVector<float>(mat.rows());
+      }
+
+      DenseMatrix<float> x;
+      solver.solve(x, rhs);
+      DenseMatrix<double> xRef;
+      solverD.solve(xRef, rhs.cast<double>().eval());
+      ASSERT_EQ(x.cols(), (long int)nRHS);
+      for (size_t j = 0; j < nRHS; j++) {
+        Vector<float> rhsCol = rhs.col(j);
+        Vector<float> xCol = x.col(j);
+        EXPECT_LT(residual(mat, xCol, rhsCol), 1e-3);
+        EXPECT_LT((x.col(j).cast<double>() - xRef.col(j)).norm() / xRef.col(j).norm(), 1e-4);
+      }
+
+      Vector<float> rhsCol = rhs.col(0);
+      Vector<float> xCol;
+      solver.solve(xCol, rhsCol);
+      EXPECT_LT((xCol - x.col(0)).norm() / x.col(0).norm(), 1e-5);
+    }
+  }
+}
+
+TEST_F(LinearAlgebraTestSuite, TestRefactor) {
+
+  // Two matrices with the same sparsity pattern but different values
+  SparseMatrix<double> matA = buildSPDTestMatrix<double>();
+  SparseMatrix<double> matB = buildSPDTestMatrix<double>();
+  matA = matA.topLeftCorner(100, 100);
+  matB = matB.topLeftCorner(100, 100);
+  Vector<double> rhs = randomVector<double>(matA.rows());
+
+  {
+    PositiveDefiniteSolver<double> solver(matA);
+    solver.refactor(matB);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(matB, x, rhs), 1e-4);
+  }
+
+  {
+    SquareSolver<double> solver(matA);
+    solver.refactor(matB);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(matB, x, rhs), 1e-4);
+  }
+
+#ifndef GC_HAVE_SUITESPARSE
+  // Eigen is really slow, so use a tiny matrix
+  matA = matA.topLeftCorner(10, 10);
+  matB = matB.topLeftCorner(10, 10);
+  rhs = rhs.head(10).eval();
+#endif
+  {
+    Solver<double> solver(matA);
+    solver.refactor(matB);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(matB, x, rhs), 1e-4);
+  }
+
+  { // A singleton column, which SPQR splits off (so refactor() has to factor from scratch)
+    auto makeSingleton = [](SparseMatrix<double> mat) {
+      mat.prune([](Eigen::Index row, Eigen::Index col, double) { return col != 0 || row == 0; });
+      return mat;
+    };
+    SparseMatrix<double> matSA = makeSingleton(matA);
+    SparseMatrix<double> matSB = makeSingleton(matB);
+    Solver<double> solver(matSA);
+    solver.refactor(matSB);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(matSB, x, rhs), 1e-4);
+  }
+
+#ifdef GC_HAVE_SUITESPARSE
+  { // Underdetermined, where the conjugate transpose is factored
+    SparseMatrix<double> wideA = horizontalStack<double>({matA, matA});
+    SparseMatrix<double> wideB = horizontalStack<double>({matB, matB});
+    Solver<double> solver(wideA);
+    solver.refactor(wideB);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(wideB, x, rhs), 1e-4);
+  }
+#endif
+
+  { // std::complex<double>
+    SparseMatrix<std::complex<double>> matC = buildSPDTestMatrix<std::complex<double>>();
+    SparseMatrix<std::complex<double>> matD = buildSPDTestMatrix<std::complex<double>>();
+    matC = matC.topLeftCorner(100, 100);
+    matD = matD.topLeftCorner(100, 100);
+    Vector<std::complex<double>> rhsC = randomVector<std::complex<double>>(matC.rows());
+
+    PositiveDefiniteSolver<std::complex<double>> solver(matC);
+    solver.refactor(matD);
+    Vector<std::complex<double>> x = solver.solve(rhsC);
+    EXPECT_LT(residual(matD, x, rhsC), 1e-4);
+  }
+
+#ifdef GC_HAVE_SUITESPARSE
+  { // Changing the sparsity pattern is an error
+    PositiveDefiniteSolver<double> solver(matA);
+    SparseMatrix<double> idMat = identityMatrix<double>(matA.rows());
+    EXPECT_THROW(solver.refactor(idMat), std::logic_error);
+  }
+#endif
+}
+
+TEST_F(LinearAlgebraTestSuite, TestLowRankUpdate) {
+
+  // Change the weights of a few edges, and add a new one (which changes the sparsity pattern)
+  auto buildDelta = [&](size_t N) {
+    std::vector<Eigen::Triplet<double>> tripletList;
+    auto addEdge = [&](size_t vA, size_t vB, double w) {
+      tripletList.emplace_back(vA, vA, w);
+      tripletList.emplace_back(vB, vB, w);
+      tripletList.emplace_back(vA, vB, -w);
+      tripletList.emplace_back(vB, vA, -w);
+    };
+    SparseMatrix<double> mat = buildSPDTestMatrix<double>().topLeftCorner(N, N);
+    size_t nChanged = 0;
+    for (int k = 0; k < mat.outerSize() && nChanged < 4; k++) {
+      for (SparseMatrix<double>::InnerIterator it(mat, k); it; ++it) {
+        if (it.row() < it.col()) {
+          addEdge(it.row(), it.col(), (nChanged % 2 == 0) ? 0.5 : -0.05); // edge weights are at least 0.1
+          nChanged++;
+          break;
+        }
+      }
+    }
+    addEdge(0, N - 1, 0.3);
+    SparseMatrix<double> delta(N, N);
+    delta.setFromTriplets(tripletList.begin(), tripletList.end());
+    return delta;
+  };
+
+  { // double
+    SparseMatrix<double> mat = buildSPDTestMatrix<double>();
+    mat = mat.topLeftCorner(100, 100);
+    SparseMatrix<double> delta = buildDelta(mat.rows());
+    Vector<double> rhs = randomVector<double>(mat.rows());
+
+    PositiveDefiniteSolver<double> solver(mat);
+    solver.update(delta);
+    SparseMatrix<double> newMat = mat + delta;
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(newMat, x, rhs), 1e-4);
+
+    // Undo it again
+    SparseMatrix<double> negDelta = -delta;
+    solver.update(negDelta);
+    x = solver.solve(rhs);
+    EXPECT_LT(residual(mat, x, rhs), 1e-4);
+
+    // The factorization can still be refactored with the pattern of the updated matrix
+    solver.refactor(newMat);
+    x = solver.solve(rhs);
+    EXPECT_LT(residual(newMat, x, rhs), 1e-4);
+  }
+
+  { // std::complex<double>
+    SparseMatrix<std::complex<double>> mat = buildSPDTestMatrix<std::complex<double>>();
+    mat = mat.topLeftCorner(100, 100);
+    SparseMatrix<std::complex<double>> delta = buildDelta(mat.rows()).cast<std::complex<double>>();
+    Vector<std::complex<double>> rhs = randomVector<std::complex<double>>(mat.rows());
+
+    PositiveDefiniteSolver<std::complex<double>> solver(mat);
+    solver.update(delta);
+    SparseMatrix<std::complex<double>> newMat = mat + delta;
+    Vector<std::complex<double>> x = solver.solve(rhs);
+    EXPECT_LT(residual(newMat, x, rhs), 1e-4);
+  }
+
+  { // badly scaled: a grid Laplacian with small weights, pinned by a large penalty on one diagonal entry (as for a
+    // soft constraint)
+    const int n = 30;
+    std::vector<Eigen::Triplet<double>> tripletList;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        int vA = i * n + j;
+        for (int vB : {i + 1 < n ? vA + n : -1, j + 1 < n ? vA + 1 : -1}) {
+          if (vB == -1) continue;
+          tripletList.emplace_back(vA, vA, 1e-3);
+          tripletList.emplace_back(vB, vB, 1e-3);
+          tripletList.emplace_back(vA, vB, -1e-3);
+          tripletList.emplace_back(vB, vA, -1e-3);
+        }
+      }
+    }
+    tripletList.emplace_back(0, 0, 1e13);
+    SparseMatrix<double> mat(n * n, n * n);
+    mat.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    // Strengthen one edge, weaken another, and add a new one
+    tripletList.clear();
+    auto addEdge = [&](int vA, int vB, double w) {
+      tripletList.emplace_back(vA, vA, w);
+      tripletList.emplace_back(vB, vB, w);
+      tripletList.emplace_back(vA, vB, -w);
+      tripletList.emplace_back(vB, vA, -w);
+    };
+    addEdge(1, 2, 5e-4);
+    addEdge(n, n + 1, -5e-4);
+    addEdge(0, n * n - 1, 3e-4);
+    SparseMatrix<double> delta(n * n, n * n);
+    delta.setFromTriplets(tripletList.begin(), tripletList.end());
+    SparseMatrix<double> newMat = mat + delta;
+    Vector<double> rhs = randomVector<double>(mat.rows());
+
+    PositiveDefiniteSolver<double> solver(mat);
+    solver.update(delta);
+    Vector<double> x = solver.solve(rhs);
+    EXPECT_LT(residual(newMat, x, rhs) / rhs.norm(), 1e-8);
+
+    SparseMatrix<double> negDelta = -delta;
+    solver.update(negDelta);
+    x = solver.solve(rhs);
+    EXPECT_LT(residual(mat, x, rhs) / rhs.norm(), 1e-8);
+  }
+}
+
 // TODO test eigenvalue routines